@@ -0,0 +1,143 @@
+#include "UMCP_BlueprintGraphExport.h" // For FUMCP_BlueprintGraphExport
+#include "UMCP_UriTemplate.h" // For FUMCP_UriTemplate
+#include "Dom/JsonObject.h" // For FJsonObject
+#include "Serialization/JsonSerializer.h" // For FJsonSerializer
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_BlueprintGraphExportTests_ParseFields, "Plugin.MCP.BlueprintGraphExport::ParseFields", "[BlueprintGraphExport][SmokeFilter]")
+{
+    using EFields = FUMCP_BlueprintGraphExport::EFields;
+    EFields Fields = EFields::None;
+    FString Error;
+
+    CHECK_MESSAGE(TEXT("No fields should select the defaults."), FUMCP_BlueprintGraphExport::ParseFields({}, Fields, Error) && Fields == EFields::Default);
+    CHECK_MESSAGE(TEXT("Positions should be left out by default."), !EnumHasAnyFlags(EFields::Default, EFields::Positions));
+
+    const TArray<FString> LinkNames = { TEXT("Links") };
+    CHECK_MESSAGE(TEXT("Field names should parse ignoring case."), FUMCP_BlueprintGraphExport::ParseFields(LinkNames, Fields, Error));
+    CHECK_MESSAGE(TEXT("Links should bring in the nodes and graphs they are in."), Fields == (EFields::Links | EFields::Nodes | EFields::Graphs));
+
+    const TArray<FString> VariableNames = { TEXT("variables") };
+    CHECK_MESSAGE(TEXT("Fields outside of graphs should not imply graphs."),
+        FUMCP_BlueprintGraphExport::ParseFields(VariableNames, Fields, Error) && Fields == EFields::Variables);
+
+    const TArray<FString> UnknownNames = { TEXT("variables"), TEXT("guids") };
+    CHECK_MESSAGE(TEXT("Unknown fields should be rejected."), !FUMCP_BlueprintGraphExport::ParseFields(UnknownNames, Fields, Error));
+    CHECK_MESSAGE(TEXT("The error should name the unknown field."), Error.Contains(TEXT("guids")));
+}
+
+namespace
+{
+    // Macro library that ships with the engine, so it is there in every editor
+    const TCHAR* StandardMacrosPath = TEXT("/Engine/EditorBlueprintResources/StandardMacros.StandardMacros");
+
+    TSharedPtr<FJsonObject> ExportAsJsonObject(FUMCP_BlueprintGraphExport::EFields Fields)
+    {
+        FString Json;
+        TSharedPtr<FJsonObject> Root;
+        if (FUMCP_BlueprintGraphExport::Export(StandardMacrosPath, Fields, Json))
+        {
+            FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root);
+        }
+        return Root;
+    }
+
+    TSharedPtr<FJsonObject> FindPin(const TArray<TSharedPtr<FJsonValue>>& Nodes, int32 NodeId, const FString& PinName)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Pins = nullptr;
+        if (!Nodes.IsValidIndex(NodeId) || !Nodes[NodeId]->AsObject()->TryGetArrayField(TEXT("pins"), Pins))
+        {
+            return nullptr;
+        }
+        for (const TSharedPtr<FJsonValue>& Pin : *Pins)
+        {
+            if (Pin->AsObject()->GetStringField(TEXT("name")) == PinName)
+            {
+                return Pin->AsObject();
+            }
+        }
+        return nullptr;
+    }
+}
+
+TEST_CASE_NAMED(FUMCP_BlueprintGraphExportTests_Export, "Plugin.MCP.BlueprintGraphExport::Export", "[BlueprintGraphExport]")
+{
+    using EFields = FUMCP_BlueprintGraphExport::EFields;
+    TSharedPtr<FJsonObject> Root = ExportAsJsonObject(EFields::Default);
+    CHECK_MESSAGE(TEXT("StandardMacros should export as a JSON object."), Root.IsValid());
+    if (!Root.IsValid())
+    {
+        return;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Graphs = nullptr;
+    CHECK_MESSAGE(TEXT("The export should name the Blueprint."), Root->GetStringField(TEXT("blueprint")).EndsWith(TEXT("StandardMacros")));
+    CHECK_MESSAGE(TEXT("The export should list graphs."), Root->TryGetArrayField(TEXT("graphs"), Graphs) && Graphs->Num() > 0);
+    CHECK_MESSAGE(TEXT("Variables should be listed, even when there are none."), Root->HasTypedField<EJson::Array>(TEXT("variables")));
+    if (!Graphs)
+    {
+        return;
+    }
+
+    int32 NumLinks = 0;
+    bool bLinksResolve = true;
+    bool bAnyPosition = false;
+    bool bAnyMacro = false;
+    for (const TSharedPtr<FJsonValue>& GraphValue : *Graphs)
+    {
+        const TSharedPtr<FJsonObject>& Graph = GraphValue->AsObject();
+        bAnyMacro |= Graph->GetStringField(TEXT("kind")) == TEXT("macro");
+        const TArray<TSharedPtr<FJsonValue>>* Nodes = nullptr;
+        const TArray<TSharedPtr<FJsonValue>>* Links = nullptr;
+        if (!Graph->TryGetArrayField(TEXT("nodes"), Nodes) || !Graph->TryGetArrayField(TEXT("links"), Links))
+        {
+            bLinksResolve = false;
+            continue;
+        }
+        for (const TSharedPtr<FJsonValue>& Node : *Nodes)
+        {
+            bAnyPosition |= Node->AsObject()->HasField(TEXT("pos"));
+        }
+        // Each link runs from an output pin to an input pin of nodes in the same graph
+        for (const TSharedPtr<FJsonValue>& LinkValue : *Links)
+        {
+            const TArray<TSharedPtr<FJsonValue>>& Link = LinkValue->AsArray();
+            ++NumLinks;
+            if (Link.Num() != 4)
+            {
+                bLinksResolve = false;
+                continue;
+            }
+            const TSharedPtr<FJsonObject> FromPin = FindPin(*Nodes, static_cast<int32>(Link[0]->AsNumber()), Link[1]->AsString());
+            const TSharedPtr<FJsonObject> ToPin = FindPin(*Nodes, static_cast<int32>(Link[2]->AsNumber()), Link[3]->AsString());
+            bLinksResolve &= FromPin.IsValid() && ToPin.IsValid() && FromPin->GetStringField(TEXT("dir")) == TEXT("out") && ToPin->GetStringField(TEXT("dir")) == TEXT("in");
+        }
+    }
+    CHECK_MESSAGE(TEXT("Macro graphs should be exported as macros."), bAnyMacro);
+    CHECK_MESSAGE(TEXT("The macros should have links."), NumLinks > 0);
+    CHECK_MESSAGE(TEXT("Links should be [fromNode, fromPin, toNode, toPin] with an output pin first."), bLinksResolve);
+    CHECK_MESSAGE(TEXT("Positions should be left out by default."), !bAnyPosition);
+
+    TSharedPtr<FJsonObject> NodesOnly = ExportAsJsonObject(EFields::Nodes | EFields::Graphs);
+    const TArray<TSharedPtr<FJsonValue>>* NodeGraphs = nullptr;
+    CHECK_MESSAGE(TEXT("Fields not asked for should be left out."), NodesOnly.IsValid() && !NodesOnly->HasField(TEXT("variables"))
+        && NodesOnly->TryGetArrayField(TEXT("graphs"), NodeGraphs) && NodeGraphs->Num() > 0 && !(*NodeGraphs)[0]->AsObject()->HasField(TEXT("links")));
+}
+
+TEST_CASE_NAMED(FUMCP_BlueprintGraphExportTests_ResourceUri, "Plugin.MCP.BlueprintGraphExport::ResourceUri", "[BlueprintGraphExport]")
+{
+    FUMCP_UriTemplate UriTemplate(TEXT("unreal+bpgraph://{filepath}{?fields}"));
+    FUMCP_UriTemplateMatch Match;
+    CHECK_MESSAGE(TEXT("A URI without fields should match."), UriTemplate.FindMatch(TEXT("unreal+bpgraph:///Game/BP_Test.BP_Test"), Match) && !Match.Variables.Contains(TEXT("fields")));
+
+    Match = FUMCP_UriTemplateMatch();
+    CHECK_MESSAGE(TEXT("A URI with fields should match."), UriTemplate.FindMatch(TEXT("unreal+bpgraph:///Game/BP_Test.BP_Test?fields=nodes,links"), Match));
+    const TArray<FString>* FilePath = Match.Variables.Find(TEXT("filepath"));
+    const TArray<FString>* Fields = Match.Variables.Find(TEXT("fields"));
+    CHECK_MESSAGE(TEXT("The path should stop at the query."), FilePath && FilePath->Num() == 1 && (*FilePath)[0] == TEXT("/Game/BP_Test.BP_Test"));
+    CHECK_MESSAGE(TEXT("The field list should arrive as one value."), Fields && Fields->Num() == 1 && (*Fields)[0] == TEXT("nodes,links"));
+}
+
+#endif
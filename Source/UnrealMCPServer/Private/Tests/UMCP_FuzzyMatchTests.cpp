@@ -0,0 +1,30 @@
+#include "UMCP_FuzzyMatch.h" // For FUMCP_FuzzyMatch
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_FuzzyMatchTests_Ranking, "Plugin.MCP.FuzzyMatch::Ranking", "[FuzzyMatch][SmokeFilter]")
+{
+    const int32 Exact = FUMCP_FuzzyMatch::Score(TEXT("bp_door"), TEXT("BP_Door"));
+    const int32 Prefix = FUMCP_FuzzyMatch::Score(TEXT("BP_Door"), TEXT("BP_DoorBell"));
+    const int32 Substring = FUMCP_FuzzyMatch::Score(TEXT("Door"), TEXT("BP_DoorBell"));
+    const int32 Subsequence = FUMCP_FuzzyMatch::Score(TEXT("PlyrCtrl"), TEXT("BP_PlayerController"));
+    const int32 Typo = FUMCP_FuzzyMatch::Score(TEXT("PlayreController"), TEXT("BP_PlayerController"));
+
+    CHECK_MESSAGE(TEXT("Equal names should score the maximum, ignoring case."), Exact == FUMCP_FuzzyMatch::MaxScore);
+    CHECK_MESSAGE(TEXT("A prefix should outrank a substring."), Prefix > Substring);
+    CHECK_MESSAGE(TEXT("A substring should outrank an abbreviation."), Substring > Subsequence);
+    CHECK_MESSAGE(TEXT("An abbreviation should outrank a typo."), Subsequence > Typo);
+    CHECK_MESSAGE(TEXT("A small typo should still match."), Typo > 0);
+    CHECK_MESSAGE(TEXT("Unrelated names should not match."), FUMCP_FuzzyMatch::Score(TEXT("PlyrCtrl"), TEXT("BP_Door")) == 0);
+}
+
+TEST_CASE_NAMED(FUMCP_FuzzyMatchTests_WordStarts, "Plugin.MCP.FuzzyMatch::WordStarts", "[FuzzyMatch]")
+{
+    CHECK_MESSAGE(TEXT("Matching at camel-case word starts should beat scattered matches."),
+        FUMCP_FuzzyMatch::Score(TEXT("PC"), TEXT("BP_PlayerController")) > FUMCP_FuzzyMatch::Score(TEXT("PC"), TEXT("BP_Epic")));
+    CHECK_MESSAGE(TEXT("Shorter candidates should win among abbreviations."),
+        FUMCP_FuzzyMatch::Score(TEXT("PlyrCtrl"), TEXT("PlayerControl")) > FUMCP_FuzzyMatch::Score(TEXT("PlyrCtrl"), TEXT("BP_PlayerControllerBase")));
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "UMCP_JsonUtf8.h" // For FUMCP_JsonUtf8Reader and UMCP_SplitJsonUtf8Body
+#include "UMCP_Types.h" // For FUMCP_JsonRpcRequest
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+namespace
+{
+	TSharedPtr<const TArray<uint8>> MakeUtf8Body(const FString& Json)
+	{
+		FTCHARToUTF8 Convert(*Json);
+		return MakeShared<TArray<uint8>>(reinterpret_cast<const uint8*>(Convert.Get()), Convert.Length());
+	}
+
+	FString Utf8BytesToString(const TArray<uint8>& Bytes)
+	{
+		FUTF8ToTCHAR Convert(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+		return FString(Convert.Length(), Convert.Get());
+	}
+}
+
+// --- Body Splitting Tests ---
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8SplitTests_Single, "Plugin.MCP.JsonUtf8.Split::Single", "[JsonUtf8][Split][SmokeFilter]")
+{
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(TEXT(" {\"jsonrpc\":\"2.0\",\"method\":\"ping\",\"id\":1} "));
+    TArray<FUMCP_JsonUtf8View> Entries;
+    bool bIsBatch = true;
+
+    CHECK_MESSAGE(TEXT("A single request object should split successfully."), UMCP_SplitJsonUtf8Body(Body, Entries, bIsBatch));
+    CHECK_MESSAGE(TEXT("A single request object is not a batch."), !bIsBatch);
+    CHECK_MESSAGE(TEXT("A single request object yields one entry."), Entries.Num() == 1);
+    CHECK_MESSAGE(TEXT("The entry should exclude surrounding whitespace."), Entries.Num() == 1 && Entries[0].Offset == 1 && Entries[0].Length == Body->Num() - 2);
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8SplitTests_Batch, "Plugin.MCP.JsonUtf8.Split::Batch", "[JsonUtf8][Split][SmokeFilter]")
+{
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(TEXT("[{\"jsonrpc\":\"2.0\",\"method\":\"ping\",\"id\":1}, 42, {\"jsonrpc\":\"2.0\",\"method\":\"notifications/initialized\"}]"));
+    TArray<FUMCP_JsonUtf8View> Entries;
+    bool bIsBatch = false;
+
+    CHECK_MESSAGE(TEXT("A batch should split successfully."), UMCP_SplitJsonUtf8Body(Body, Entries, bIsBatch));
+    CHECK_MESSAGE(TEXT("An array body is a batch."), bIsBatch);
+    CHECK_MESSAGE(TEXT("Every batch element, valid request or not, yields an entry."), Entries.Num() == 3);
+
+    FUMCP_JsonRpcRequest Request;
+    CHECK_MESSAGE(TEXT("A non-object entry is not a request."), Entries.Num() == 3 && !FUMCP_JsonRpcRequest::CreateFromJsonUtf8(Entries[1], Request));
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8SplitTests_Malformed, "Plugin.MCP.JsonUtf8.Split::Malformed", "[JsonUtf8][Split]")
+{
+    TArray<FUMCP_JsonUtf8View> Entries;
+    bool bIsBatch = false;
+
+    SECTION("Truncated object")
+    {
+        CHECK_MESSAGE(TEXT("A truncated object should fail to split."), !UMCP_SplitJsonUtf8Body(MakeUtf8Body(TEXT("{\"jsonrpc\":\"2.0\"")), Entries, bIsBatch));
+    }
+    SECTION("Trailing garbage")
+    {
+        CHECK_MESSAGE(TEXT("Trailing content after the value should fail to split."), !UMCP_SplitJsonUtf8Body(MakeUtf8Body(TEXT("{} {}")), Entries, bIsBatch));
+    }
+    SECTION("Missing comma")
+    {
+        CHECK_MESSAGE(TEXT("Batch elements must be comma separated."), !UMCP_SplitJsonUtf8Body(MakeUtf8Body(TEXT("[{} {}]")), Entries, bIsBatch));
+    }
+}
+
+// --- Request Envelope Tests ---
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8RequestTests_Envelope, "Plugin.MCP.JsonUtf8.Request::Envelope", "[JsonUtf8][Request][SmokeFilter]")
+{
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(TEXT("{\"jsonrpc\":\"2.0\",\"id\":\"abc\",\"extra\":[1,{\"x\":null}],\"method\":\"tools/call\",\"params\":{\"name\":\"search_blueprints\",\"arguments\":{\"search_term\":\"Caf\\u00e9 \\ud83d\\ude00\"}}}"));
+    FUMCP_JsonRpcRequest Request;
+
+    CHECK_MESSAGE(TEXT("The envelope should parse."), FUMCP_JsonRpcRequest::CreateFromJsonUtf8(FUMCP_JsonUtf8View(Body, 0, Body->Num()), Request));
+    CHECK_MESSAGE(TEXT("method should be read."), Request.method == TEXT("tools/call"));
+    CHECK_MESSAGE(TEXT("A string id should be read."), Request.id.IsString() && Request.id.ToString() == TEXT("abc"));
+    CHECK_MESSAGE(TEXT("params should only be located, not parsed."), Request.paramsView.IsSet() && !Request.params.IsValid());
+
+    FString ToolName;
+    CHECK_MESSAGE(TEXT("A params string should be readable without a DOM."), Request.TryGetParamsStringField(TEXT("name"), ToolName) && ToolName == TEXT("search_blueprints"));
+    CHECK_MESSAGE(TEXT("TryGetParamsStringField should not build the params DOM."), !Request.params.IsValid());
+
+    TSharedPtr<FJsonObject> Params = Request.GetParams();
+    const TSharedPtr<FJsonObject>* Arguments = nullptr;
+    FString SearchTerm;
+    CHECK_MESSAGE(TEXT("GetParams should parse the params object."), Params.IsValid() && Params->TryGetObjectField(TEXT("arguments"), Arguments));
+    CHECK_MESSAGE(TEXT("Escapes and surrogate pairs should decode."), Arguments && (*Arguments)->TryGetStringField(TEXT("search_term"), SearchTerm) && SearchTerm == FString(UTF8_TO_TCHAR("Caf\xC3\xA9 \xF0\x9F\x98\x80")));
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8RequestTests_Notification, "Plugin.MCP.JsonUtf8.Request::Notification", "[JsonUtf8][Request]")
+{
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(TEXT("{\"jsonrpc\":\"2.0\",\"method\":\"notifications/initialized\"}"));
+    FUMCP_JsonRpcRequest Request;
+
+    CHECK_MESSAGE(TEXT("A notification should parse."), FUMCP_JsonRpcRequest::CreateFromJsonUtf8(FUMCP_JsonUtf8View(Body, 0, Body->Num()), Request));
+    CHECK_MESSAGE(TEXT("A request without an id is a notification."), Request.IsNotification());
+    CHECK_MESSAGE(TEXT("A request without params has no params."), !Request.GetParams().IsValid());
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8RequestTests_NumericId, "Plugin.MCP.JsonUtf8.Request::NumericId", "[JsonUtf8][Request]")
+{
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1234567,\"method\":\"ping\"}"));
+    TSharedPtr<const TArray<uint8>> NextBody = MakeUtf8Body(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1234568,\"method\":\"ping\"}"));
+    FUMCP_JsonRpcRequest Request;
+    FUMCP_JsonRpcRequest NextRequest;
+
+    CHECK_MESSAGE(TEXT("Both requests should parse."), FUMCP_JsonRpcRequest::CreateFromJsonUtf8(FUMCP_JsonUtf8View(Body, 0, Body->Num()), Request)
+        && FUMCP_JsonRpcRequest::CreateFromJsonUtf8(FUMCP_JsonUtf8View(NextBody, 0, NextBody->Num()), NextRequest));
+    CHECK_MESSAGE(TEXT("An integral id should print exactly."), Request.id.IsNumber() && Request.id.ToString() == TEXT("1234567"));
+    CHECK_MESSAGE(TEXT("Neighbouring ids should print differently."), Request.id.ToString() != NextRequest.id.ToString());
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8ReaderTests_Depth, "Plugin.MCP.JsonUtf8.Reader::Depth", "[JsonUtf8][Reader]")
+{
+    FString Nested = FString::ChrN(2000, TEXT('[')) + FString::ChrN(2000, TEXT(']'));
+    TSharedPtr<const TArray<uint8>> Body = MakeUtf8Body(Nested);
+    FUMCP_JsonUtf8Reader Reader(*Body);
+
+    CHECK_MESSAGE(TEXT("Excessively nested input should be rejected."), !Reader.SkipValue() && Reader.HasError());
+}
+
+// --- Writer Tests ---
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8WriterTests_RoundTrip, "Plugin.MCP.JsonUtf8.Writer::RoundTrip", "[JsonUtf8][Writer][SmokeFilter]")
+{
+    TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+    Object->SetStringField(TEXT("text"), FString(UTF8_TO_TCHAR("line\n\"quoted\"\t\x01 Caf\xC3\xA9 \xF0\x9F\x98\x80")));
+    Object->SetNumberField(TEXT("count"), 42);
+    Object->SetNumberField(TEXT("ratio"), 0.25);
+    Object->SetBoolField(TEXT("flag"), true);
+    Object->SetArrayField(TEXT("list"), { MakeShared<FJsonValueNull>(), MakeShared<FJsonValueString>(TEXT("x")) });
+
+    TArray<uint8> Bytes;
+    FUMCP_JsonUtf8Writer(Bytes).WriteObject(*Object);
+    CHECK_MESSAGE(TEXT("Whole numbers should be written without a fraction."), Utf8BytesToString(Bytes).Contains(TEXT("\"count\":42,")));
+
+    TSharedPtr<const TArray<uint8>> Body = MakeShared<TArray<uint8>>(MoveTemp(Bytes));
+    TSharedPtr<FJsonObject> Parsed = FUMCP_JsonUtf8View(Body, 0, Body->Num()).ParseObject();
+    CHECK_MESSAGE(TEXT("Writer output should parse back."), Parsed.IsValid());
+    CHECK_MESSAGE(TEXT("Strings should round-trip through escaping and UTF-8."), Parsed.IsValid() && Parsed->GetStringField(TEXT("text")) == Object->GetStringField(TEXT("text")));
+    CHECK_MESSAGE(TEXT("Numbers should round-trip."), Parsed.IsValid() && Parsed->GetNumberField(TEXT("ratio")) == 0.25);
+    CHECK_MESSAGE(TEXT("Arrays should round-trip."), Parsed.IsValid() && Parsed->GetArrayField(TEXT("list")).Num() == 2);
+}
+
+TEST_CASE_NAMED(FUMCP_JsonUtf8WriterTests_Response, "Plugin.MCP.JsonUtf8.Writer::Response", "[JsonUtf8][Writer]")
+{
+    FUMCP_JsonRpcResponse Response;
+    Response.id = FUMCP_JsonRpcId(7);
+    Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::MethodNotFound, TEXT("Method not found"));
+
+    TArray<uint8> Bytes;
+    CHECK_MESSAGE(TEXT("An error response should encode."), Response.ToJsonUtf8(Bytes));
+    const FString Json = Utf8BytesToString(Bytes);
+    CHECK_MESSAGE(TEXT("The error response should be condensed JSON-RPC."), Json == TEXT("{\"jsonrpc\":\"2.0\",\"id\":7,\"error\":{\"code\":-32601,\"message\":\"Method not found\"}}"));
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include "UMCP_Metrics.h" // For FUMCP_LatencyHistogram
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_MetricsTests_Percentiles, "Plugin.MCP.Metrics.Histogram::Percentiles", "[Metrics][SmokeFilter]")
+{
+    FUMCP_LatencyHistogram Histogram;
+    CHECK_MESSAGE(TEXT("An empty histogram reports zero."), Histogram.GetPercentileMs(50.0) == 0.0);
+
+    // 1ms to 100ms in 1ms steps
+    for (int32 Millis = 1; Millis <= 100; ++Millis)
+    {
+        Histogram.Add(Millis / 1000.0);
+    }
+
+    const double P50 = Histogram.GetPercentileMs(50.0);
+    const double P95 = Histogram.GetPercentileMs(95.0);
+    const double P99 = Histogram.GetPercentileMs(99.0);
+    CHECK_MESSAGE(TEXT("Every sample should be counted."), Histogram.GetCount() == 100);
+    CHECK_MESSAGE(TEXT("p50 should be within a bucket of the true median."), P50 >= 50.0 && P50 <= 50.0 * 1.2);
+    CHECK_MESSAGE(TEXT("p95 should be within a bucket of the true value."), P95 >= 95.0 && P95 <= 95.0 * 1.2);
+    CHECK_MESSAGE(TEXT("Percentiles never exceed the largest sample."), P99 <= Histogram.GetMaxMs() && Histogram.GetPercentileMs(100.0) == Histogram.GetMaxMs());
+    CHECK_MESSAGE(TEXT("The mean should be exact."), FMath::IsNearlyEqual(Histogram.GetMeanMs(), 50.5, 1e-6));
+}
+
+#endif
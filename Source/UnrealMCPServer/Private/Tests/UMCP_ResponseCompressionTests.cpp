@@ -0,0 +1,35 @@
+#include "UMCP_ResponseCompression.h" // For FUMCP_ResponseCompression
+#include "Misc/Compression.h" // For FCompression
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_ResponseCompressionTests_Negotiate, "Plugin.MCP.ResponseCompression::Negotiate", "[ResponseCompression][SmokeFilter]")
+{
+    CHECK_MESSAGE(TEXT("No header should mean no compression."), FUMCP_ResponseCompression::Negotiate(TEXT("")) == EUMCP_ContentEncoding::Identity);
+    CHECK_MESSAGE(TEXT("gzip should win a tie."), FUMCP_ResponseCompression::Negotiate(TEXT("deflate, gzip, br")) == EUMCP_ContentEncoding::Gzip);
+    CHECK_MESSAGE(TEXT("Coding names should match ignoring case."), FUMCP_ResponseCompression::Negotiate(TEXT("GZIP")) == EUMCP_ContentEncoding::Gzip);
+    CHECK_MESSAGE(TEXT("A higher q-value should win."), FUMCP_ResponseCompression::Negotiate(TEXT("deflate;q=1.0, gzip;q=0.5")) == EUMCP_ContentEncoding::Deflate);
+    CHECK_MESSAGE(TEXT("q=0 should rule a coding out."), FUMCP_ResponseCompression::Negotiate(TEXT("gzip;q=0, deflate")) == EUMCP_ContentEncoding::Deflate);
+    CHECK_MESSAGE(TEXT("* should stand in for codings not named."), FUMCP_ResponseCompression::Negotiate(TEXT("*")) == EUMCP_ContentEncoding::Gzip);
+    CHECK_MESSAGE(TEXT("* should not override a coding that is named."), FUMCP_ResponseCompression::Negotiate(TEXT("gzip;q=0, *")) == EUMCP_ContentEncoding::Deflate);
+    CHECK_MESSAGE(TEXT("Unsupported codings should be ignored."), FUMCP_ResponseCompression::Negotiate(TEXT("br, zstd")) == EUMCP_ContentEncoding::Identity);
+}
+
+TEST_CASE_NAMED(FUMCP_ResponseCompressionTests_Compress, "Plugin.MCP.ResponseCompression::Compress", "[ResponseCompression]")
+{
+    const FString Text = FString::ChrN(4096, TEXT('a'));
+    const TArray<uint8> Original(reinterpret_cast<const uint8*>(TCHAR_TO_UTF8(*Text)), Text.Len());
+
+    TArray<uint8> Payload = Original;
+    CHECK_MESSAGE(TEXT("Repetitive text should compress."), FUMCP_ResponseCompression::Compress(EUMCP_ContentEncoding::Deflate, Payload) && Payload.Num() < Original.Num());
+    TArray<uint8> Uncompressed;
+    Uncompressed.SetNumUninitialized(Original.Num());
+    CHECK_MESSAGE(TEXT("deflate should be the zlib format."),
+        FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), Uncompressed.Num(), Payload.GetData(), Payload.Num()) && Uncompressed == Original);
+
+    TArray<uint8> Tiny = { '{', '}' };
+    CHECK_MESSAGE(TEXT("A payload that would grow should be left alone."), !FUMCP_ResponseCompression::Compress(EUMCP_ContentEncoding::Gzip, Tiny) && Tiny.Num() == 2);
+}
+
+#endif
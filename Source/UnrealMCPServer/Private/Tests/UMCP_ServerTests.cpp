@@ -0,0 +1,46 @@
+#include "UMCP_Server.h" // For FUMCP_Server::GetSessionKey and GetInFlightKey
+#include "UMCP_Types.h" // For FUMCP_JsonRpcId
+#include "Dom/JsonValue.h" // For FJsonValueNumber
+#include "SocketSubsystem.h" // For ISocketSubsystem
+#include "IPAddress.h" // For FInternetAddr
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+namespace
+{
+	FHttpServerRequest MakePeerRequest(uint32 Ip, int32 Port)
+	{
+		FHttpServerRequest Request;
+		Request.PeerAddress = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+		Request.PeerAddress->SetIp(Ip);
+		Request.PeerAddress->SetPort(Port);
+		return Request;
+	}
+}
+
+// --- Session Key Tests ---
+
+TEST_CASE_NAMED(FUMCP_ServerSessionTests_SessionId, "Plugin.MCP.Server.Session::SessionId", "[Server][Session][SmokeFilter]")
+{
+    FHttpServerRequest Request = MakePeerRequest(0x7F000001, 50001);
+    Request.Headers.Add(TEXT("mcp-session-id"), { TEXT("0b5f0ad2-5c4e-4d5e-9b3a-0f6c1e2d3a4b") });
+
+    CHECK_MESSAGE(TEXT("The session id should be the key, whatever the header casing."), FUMCP_Server::GetSessionKey(Request) == TEXT("0b5f0ad2-5c4e-4d5e-9b3a-0f6c1e2d3a4b"));
+}
+
+TEST_CASE_NAMED(FUMCP_ServerSessionTests_CancelFromOtherPort, "Plugin.MCP.Server.Session::CancelFromOtherPort", "[Server][Session][SmokeFilter]")
+{
+    // Clients without a session may send the cancellation over a new connection
+    const FHttpServerRequest Request = MakePeerRequest(0x7F000001, 50001);
+    const FHttpServerRequest Cancel = MakePeerRequest(0x7F000001, 50002);
+    const FHttpServerRequest OtherHost = MakePeerRequest(0x7F000002, 50001);
+    const FUMCP_JsonRpcId RequestId = FUMCP_JsonRpcId::CreateFromJsonValue(MakeShared<FJsonValueNumber>(7));
+
+    const FString RequestKey = FUMCP_Server::GetInFlightKey(FUMCP_Server::GetSessionKey(Request), RequestId);
+    CHECK_MESSAGE(TEXT("The key should not be empty for a peer without a session."), !FUMCP_Server::GetSessionKey(Request).IsEmpty());
+    CHECK_MESSAGE(TEXT("A cancel from another port of the same host should find the request."), RequestKey == FUMCP_Server::GetInFlightKey(FUMCP_Server::GetSessionKey(Cancel), RequestId));
+    CHECK_MESSAGE(TEXT("A cancel from another host should not find the request."), RequestKey != FUMCP_Server::GetInFlightKey(FUMCP_Server::GetSessionKey(OtherHost), RequestId));
+}
+
+#endif
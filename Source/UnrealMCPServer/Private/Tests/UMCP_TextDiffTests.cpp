@@ -0,0 +1,35 @@
+#include "UMCP_TextDiff.h" // For FUMCP_TextDiff
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_TextDiffTests_Hunks, "Plugin.MCP.TextDiff::Hunks", "[TextDiff][SmokeFilter]")
+{
+    FString Diff;
+    CHECK_MESSAGE(TEXT("Equal texts should give an empty diff."),
+        FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb\n"), TEXT("a\nb\n"), Diff) && Diff.IsEmpty());
+
+    FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb\nc\n"), TEXT("a\nx\nc\n"), Diff);
+    CHECK_MESSAGE(TEXT("A changed line should be deleted and inserted in one hunk."), Diff == TEXT("@@ -2,1 +2,1 @@\n-b\n+x\n"));
+
+    FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nc\n"), TEXT("a\nb\nc\n"), Diff);
+    CHECK_MESSAGE(TEXT("An insertion should be numbered by the line before it in the old text."), Diff == TEXT("@@ -1,0 +2,1 @@\n+b\n"));
+
+    FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb\nc\nd\ne\n"), TEXT("b\nc\nX\ne\nf\n"), Diff);
+    CHECK_MESSAGE(TEXT("Separate edits should get separate hunks."),
+        Diff == TEXT("@@ -1,1 +0,0 @@\n-a\n@@ -4,1 +3,1 @@\n-d\n+X\n@@ -5,0 +5,1 @@\n+f\n"));
+
+    FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb"), TEXT("a\nb\n"), Diff);
+    CHECK_MESSAGE(TEXT("A missing final line break should be marked."), Diff == TEXT("@@ -2,1 +2,1 @@\n-b\n\\ No newline at end of file\n+b\n"));
+}
+
+TEST_CASE_NAMED(FUMCP_TextDiffTests_MaxEdits, "Plugin.MCP.TextDiff::MaxEdits", "[TextDiff]")
+{
+    FString Diff;
+    CHECK_MESSAGE(TEXT("A diff needing more edits than allowed should fail."),
+        !FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb\nc\n"), TEXT("x\ny\nz\n"), Diff, 5));
+    CHECK_MESSAGE(TEXT("A diff within the allowed edits should succeed."),
+        FUMCP_TextDiff::MakeUnifiedDiff(TEXT("a\nb\nc\n"), TEXT("x\ny\nz\n"), Diff, 6));
+}
+
+#endif
@@ -0,0 +1,43 @@
+#include "UMCP_TrigramIndex.h" // For FUMCP_TrigramIndex
+#include "Tests/TestHarnessAdapter.h" // For TEST_CASE_NAMED and CHECK_MESSAGE
+
+#if WITH_TESTS
+
+TEST_CASE_NAMED(FUMCP_TrigramIndexTests_Candidates, "Plugin.MCP.TrigramIndex::Candidates", "[TrigramIndex][SmokeFilter]")
+{
+    FUMCP_TrigramIndex Index;
+    Index.Add(0, TEXT("bp_playercontroller"));
+    Index.Add(1, TEXT("bp_playerpawn"));
+    Index.Add(2, TEXT("bp_enemypawn"));
+
+    TArray<int32> Ids;
+    CHECK_MESSAGE(TEXT("A term of three or more characters should use the index."), Index.FindCandidates(TEXT("player"), Ids));
+    CHECK_MESSAGE(TEXT("Only strings with every trigram of the term are candidates."), Ids == TArray<int32>({ 0, 1 }));
+
+    Index.FindCandidates(TEXT("pawn"), Ids);
+    CHECK_MESSAGE(TEXT("Candidates should come back sorted."), Ids == TArray<int32>({ 1, 2 }));
+
+    Index.FindCandidates(TEXT("zzz"), Ids);
+    CHECK_MESSAGE(TEXT("An unknown trigram yields no candidates."), Ids.IsEmpty());
+
+    CHECK_MESSAGE(TEXT("Terms shorter than a trigram should be left to a scan."), !Index.FindCandidates(TEXT("bp"), Ids));
+}
+
+TEST_CASE_NAMED(FUMCP_TrigramIndexTests_Remove, "Plugin.MCP.TrigramIndex::Remove", "[TrigramIndex]")
+{
+    FUMCP_TrigramIndex Index;
+    Index.Add(0, TEXT("bp_door"));
+    Index.Add(1, TEXT("bp_doorbell"));
+    Index.Remove(0, TEXT("bp_door"));
+
+    TArray<int32> Ids;
+    Index.FindCandidates(TEXT("door"), Ids);
+    CHECK_MESSAGE(TEXT("A removed id should no longer be a candidate."), Ids == TArray<int32>({ 1 }));
+
+    // Reused ids land in the middle of existing posting lists
+    Index.Add(0, TEXT("bp_trapdoor"));
+    Index.FindCandidates(TEXT("door"), Ids);
+    CHECK_MESSAGE(TEXT("A re-added id should be found, in order."), Ids == TArray<int32>({ 0, 1 }));
+}
+
+#endif
@@ -134,4 +134,34 @@ TEST_CASE_NAMED(FUMCP_UriTemplateMatchTests_Level2, "Plugin.MCP.UriTemplate.Matc
     }
 }
 
+TEST_CASE_NAMED(FUMCP_UriTemplateMatchTests_Level3, "Plugin.MCP.UriTemplate.Match::Level3", "[UriTemplate][Match][Level3]")
+{
+    SECTION("Query Matching")
+    {
+		DoUriTemplateMatchCheck(TEXT("/search{?q,lang}"), TEXT("/search?lang=en&q=cat%20food"), TMap<FString, TArray<FString>>{
+			{TEXT("q"), TArray<FString>{ TEXT("cat food") }},
+			{TEXT("lang"), TArray<FString>{ TEXT("en") }},
+		});
+		DoUriTemplateMatchCheck(TEXT("/search{?q,lang}"), TEXT("/search?q=cat"), TMap<FString, TArray<FString>>{
+			{TEXT("q"), TArray<FString>{ TEXT("cat") }},
+		});
+		DoUriTemplateMatchFail(TEXT("/search{?q}"), TEXT("/search?lang=en"));
+    }
+
+    SECTION("Resource Templates")
+    {
+		DoUriTemplateMatchCheck(TEXT("unreal+t3d://{filepath}{?knownVersion}"), TEXT("unreal+t3d:///Game/BP_Test.BP_Test"), TMap<FString, TArray<FString>>{
+			{TEXT("filepath"), TArray<FString>{ TEXT("/Game/BP_Test.BP_Test") }},
+		});
+		DoUriTemplateMatchCheck(TEXT("unreal+t3d://{filepath}{?knownVersion}"), TEXT("unreal+t3d:///Game/BP_Test.BP_Test?knownVersion=0123456789abcdef"), TMap<FString, TArray<FString>>{
+			{TEXT("filepath"), TArray<FString>{ TEXT("/Game/BP_Test.BP_Test") }},
+			{TEXT("knownVersion"), TArray<FString>{ TEXT("0123456789abcdef") }},
+		});
+		DoUriTemplateMatchCheck(TEXT("unreal+bpgraph://{filepath}{?fields}"), TEXT("unreal+bpgraph:///Game/BP_Test.BP_Test?fields=nodes,links"), TMap<FString, TArray<FString>>{
+			{TEXT("filepath"), TArray<FString>{ TEXT("/Game/BP_Test.BP_Test") }},
+			{TEXT("fields"), TArray<FString>{ TEXT("nodes,links") }},
+		});
+    }
+}
+
 #endif //WITH_TESTS
@@ -0,0 +1,145 @@
+#include "UMCP_BatchT3DExport.h"
+#include "UMCP_RequestContext.h"
+#include "UMCP_Scheduler.h"
+#include "UMCP_T3DExportCache.h"
+#include "UnrealMCPServerModule.h"
+
+#include "Misc/PackageName.h"
+#include "UObject/UObjectGlobals.h"
+
+void FUMCP_BatchT3DExport::Start(TArray<FString>&& InBlueprintPaths, bool bInStream, const TSharedRef<FUMCP_T3DExportCache>& InExportCache,
+	const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FUMCP_BatchT3DExport> Batch = MakeShared<FUMCP_BatchT3DExport>(MoveTemp(InBlueprintPaths), bInStream, InExportCache, InScheduler, InCompletion);
+	if (Batch->BlueprintPaths.IsEmpty())
+	{
+		Batch->Finish();
+		return;
+	}
+
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("BatchT3DExport: Loading %d Blueprints"), Batch->BlueprintPaths.Num());
+	// All requested at once, the loader works through them while the editor keeps ticking. Each callback keeps the batch alive.
+	for (int32 Index = 0; Index < Batch->BlueprintPaths.Num(); ++Index)
+	{
+		const FString PackageName = FPackageName::ObjectPathToPackageName(Batch->BlueprintPaths[Index]);
+		LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateLambda(
+			[Batch, Index](const FName& LoadedPackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+			{
+				Batch->OnPackageLoaded(Index, LoadedPackage && Result == EAsyncLoadingResult::Succeeded);
+			}));
+	}
+}
+
+FUMCP_BatchT3DExport::FUMCP_BatchT3DExport(TArray<FString>&& InBlueprintPaths, bool bInStream, const TSharedRef<FUMCP_T3DExportCache>& InExportCache,
+	const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion)
+	: BlueprintPaths(MoveTemp(InBlueprintPaths))
+	, ExportCache(InExportCache)
+	, Scheduler(InScheduler)
+	, Completion(InCompletion)
+{
+	const TSharedPtr<FUMCP_RequestContext>& Context = Completion->GetContext();
+	bStream = bInStream && Context.IsValid() && Context->IsStreaming();
+}
+
+void FUMCP_BatchT3DExport::OnPackageLoaded(int32 Index, bool bLoaded)
+{
+	if (Completion->IsCompleted())
+	{
+		return;
+	}
+	if (Completion->IsCancelled())
+	{
+		// The response is dropped anyway, the loads still in flight just go unexported
+		Completion->Complete(false, TArray<FUMCP_CallToolResultContent>());
+		return;
+	}
+
+	TSharedPtr<FUMCP_GameThreadScheduler> PinnedScheduler = Scheduler.Pin();
+	if (!PinnedScheduler.IsValid())
+	{
+		return;
+	}
+	const TSharedPtr<FUMCP_RequestContext>& Context = Completion->GetContext();
+	const FString SessionKey = Context.IsValid() ? Context->GetSessionKey() : FString();
+	// Exporting is the expensive part, so it waits for its turn rather than running inside the loader's callback
+	PinnedScheduler->Enqueue(SessionKey, EUMCP_RequestPriority::Low, [Batch = AsShared(), Index, bLoaded]()
+	{
+		Batch->ExportOne(Index, bLoaded);
+	},
+	[Batch = AsShared()]()
+	{
+		if (!Batch->Completion->IsCompleted())
+		{
+			TArray<FUMCP_CallToolResultContent> Content;
+			FUMCP_CallToolResultContent& Error = Content.AddDefaulted_GetRef();
+			Error.type = TEXT("text");
+			Error.text = TEXT("Server is shutting down");
+			Batch->Completion->Complete(false, MoveTemp(Content));
+		}
+	});
+}
+
+void FUMCP_BatchT3DExport::ExportOne(int32 Index, bool bLoaded)
+{
+	if (Completion->IsCompleted())
+	{
+		return;
+	}
+
+	const FString& BlueprintPath = BlueprintPaths[Index];
+	FString Text;
+	bool bSuccess = false;
+	if (!bLoaded)
+	{
+		Text = FString::Printf(TEXT("Failed to load Blueprint package: %s"), *BlueprintPath);
+	}
+	else
+	{
+		// The package is in memory by now, so the export no longer loads anything
+		bSuccess = ExportCache->Export(BlueprintPath, Text);
+	}
+	NumFailed += bSuccess ? 0 : 1;
+
+	// The path leads, so results can be told apart whatever order they finished in
+	FUMCP_CallToolResultContent Content;
+	Content.type = TEXT("text");
+	Content.text = BlueprintPath + TEXT("\n") + (bSuccess ? Text : TEXT("Error: ") + Text);
+
+	const TSharedPtr<FUMCP_RequestContext>& Context = Completion->GetContext();
+	if (bStream)
+	{
+		TArray<FUMCP_CallToolResultContent> PartialContent;
+		PartialContent.Add(MoveTemp(Content));
+		Context->SendPartialContent(PartialContent);
+	}
+	else
+	{
+		Results.Add(MoveTemp(Content));
+	}
+
+	++NumFinished;
+	if (Context.IsValid())
+	{
+		Context->ReportProgress(NumFinished, BlueprintPaths.Num(), FString::Printf(TEXT("Exported %s"), *BlueprintPath));
+	}
+	if (NumFinished == BlueprintPaths.Num())
+	{
+		Finish();
+	}
+}
+
+void FUMCP_BatchT3DExport::Finish()
+{
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("BatchT3DExport: Exported %d Blueprints, %d failed"), NumFinished - NumFailed, NumFailed);
+
+	TArray<FUMCP_CallToolResultContent> Content;
+	FUMCP_CallToolResultContent& Summary = Content.AddDefaulted_GetRef();
+	Summary.type = TEXT("text");
+	Summary.text = FString::Printf(TEXT("{\"exported\":%d,\"failed\":%d,\"streamed\":%s}"),
+		NumFinished - NumFailed, NumFailed, bStream ? TEXT("true") : TEXT("false"));
+	Content.Append(MoveTemp(Results));
+	// Partial failures still return what did export, only a batch where nothing exported is an error
+	Completion->Complete(NumFailed < BlueprintPaths.Num() || BlueprintPaths.IsEmpty(), MoveTemp(Content));
+}
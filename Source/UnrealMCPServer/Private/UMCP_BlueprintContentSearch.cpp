@@ -0,0 +1,174 @@
+#include "UMCP_BlueprintContentSearch.h"
+#include "UMCP_RequestContext.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "FindInBlueprintManager.h"
+
+namespace
+{
+	class FSearchDataWalker
+	{
+	public:
+		FSearchDataWalker(const TMap<int32, FText>& InLookupTable, const FString& InTerm, int32 InMaxHits, FUMCP_BlueprintContentSearch::FAssetHits& InAssetHits)
+			: LookupTable(InLookupTable)
+			, Term(InTerm)
+			, MaxHits(InMaxHits)
+			, AssetHits(InAssetHits)
+		{
+		}
+
+		void SearchObject(const FJsonObject& Object, const TCHAR* Type, const FString& ParentLocation)
+		{
+			// The object's own name extends the location of everything in it
+			FString Location = ParentLocation;
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+			{
+				const FText* Key = LookUp(Field.Key);
+				if (Key && Key->EqualTo(FFindInBlueprintSearchTags::FiB_Name) && Field.Value->Type == EJson::String)
+				{
+					if (const FText* Name = LookUp(Field.Value->AsString()))
+					{
+						Location = ParentLocation.IsEmpty() ? Name->ToString() : ParentLocation + TEXT("/") + Name->ToString();
+					}
+					break;
+				}
+			}
+
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object.Values)
+			{
+				const FText* Key = LookUp(Field.Key);
+				if (!Key)
+				{
+					continue;
+				}
+				switch (Field.Value->Type)
+				{
+				case EJson::String:
+					SearchValue(*Field.Value, Type, Location, *Key);
+					break;
+				case EJson::Object:
+					SearchObject(*Field.Value->AsObject(), Type, Location);
+					break;
+				case EJson::Array:
+					{
+						const TCHAR* ChildType = GetChildType(*Key, Type);
+						for (const TSharedPtr<FJsonValue>& Element : Field.Value->AsArray())
+						{
+							if (Element->Type == EJson::Object)
+							{
+								SearchObject(*Element->AsObject(), ChildType, Location);
+							}
+							else if (Element->Type == EJson::String)
+							{
+								SearchValue(*Element, Type, Location, *Key);
+							}
+						}
+					}
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+	private:
+		// Keys and string values in the search data are indices into its lookup table
+		const FText* LookUp(const FString& Encoded) const
+		{
+			return LookupTable.Find(FCString::Atoi(*Encoded));
+		}
+
+		static const TCHAR* GetChildType(const FText& Key, const TCHAR* ParentType)
+		{
+			if (Key.EqualTo(FFindInBlueprintSearchTags::FiB_UberGraphs) || Key.EqualTo(FFindInBlueprintSearchTags::FiB_Functions)
+				|| Key.EqualTo(FFindInBlueprintSearchTags::FiB_Macros) || Key.EqualTo(FFindInBlueprintSearchTags::FiB_SubGraphs))
+			{
+				return TEXT("graph");
+			}
+			if (Key.EqualTo(FFindInBlueprintSearchTags::FiB_Nodes))
+			{
+				return TEXT("node");
+			}
+			if (Key.EqualTo(FFindInBlueprintSearchTags::FiB_Pins))
+			{
+				return TEXT("pin");
+			}
+			if (Key.EqualTo(FFindInBlueprintSearchTags::FiB_Properties))
+			{
+				return TEXT("variable");
+			}
+			if (Key.EqualTo(FFindInBlueprintSearchTags::FiB_Components))
+			{
+				return TEXT("component");
+			}
+			return ParentType;
+		}
+
+		void SearchValue(const FJsonValue& Value, const TCHAR* Type, const FString& Location, const FText& Key)
+		{
+			const FText* Text = LookUp(Value.AsString());
+			if (!Text || !Text->ToString().Contains(Term))
+			{
+				return;
+			}
+			if (++AssetHits.TotalHits <= MaxHits)
+			{
+				FUMCP_BlueprintContentSearch::FHit& Hit = AssetHits.Hits.AddDefaulted_GetRef();
+				Hit.Type = Type;
+				Hit.Location = Location;
+				Hit.Field = Key.ToString();
+				Hit.Text = Text->ToString();
+			}
+		}
+
+		const TMap<int32, FText>& LookupTable;
+		const FString& Term;
+		int32 MaxHits;
+		FUMCP_BlueprintContentSearch::FAssetHits& AssetHits;
+	};
+}
+
+void FUMCP_BlueprintContentSearch::Search(TConstArrayView<FSoftObjectPath> AssetPaths, const FString& Term, int32 MaxHitsPerAsset, const FUMCP_RequestContext* Context, FResults& OutResults)
+{
+	// One slot per asset, so the results come out in the order of AssetPaths whatever thread searched them
+	TArray<FAssetHits> AssetHits;
+	AssetHits.SetNum(AssetPaths.Num());
+	TArray<uint8> Unindexed;
+	Unindexed.SetNumZeroed(AssetPaths.Num());
+
+	FFindInBlueprintSearchManager& SearchManager = FFindInBlueprintSearchManager::Get();
+	ParallelFor(AssetPaths.Num(), [&](int32 Index)
+	{
+		if (Context && Context->IsCancelled())
+		{
+			return;
+		}
+		// The search data is what the registry tags hold, the Blueprint itself stays unloaded
+		const FSearchData SearchData = SearchManager.GetSearchDataForAssetPath(AssetPaths[Index]);
+		if (SearchData.Value.IsEmpty())
+		{
+			Unindexed[Index] = 1;
+			return;
+		}
+		TMap<int32, FText> LookupTable;
+		const TSharedPtr<FJsonObject> Json = FFindInBlueprintSearchManager::ConvertJsonStringToObject(SearchData.VersionInfo, SearchData.Value, LookupTable);
+		if (!Json.IsValid())
+		{
+			Unindexed[Index] = 1;
+			return;
+		}
+		AssetHits[Index].AssetPath = AssetPaths[Index];
+		FSearchDataWalker(LookupTable, Term, MaxHitsPerAsset, AssetHits[Index]).SearchObject(*Json, TEXT("blueprint"), FString());
+	});
+
+	OutResults.bCancelled = Context && Context->IsCancelled();
+	for (int32 Index = 0; Index < AssetHits.Num(); ++Index)
+	{
+		OutResults.UnindexedAssets += Unindexed[Index];
+		if (AssetHits[Index].TotalHits > 0)
+		{
+			OutResults.Assets.Add(MoveTemp(AssetHits[Index]));
+		}
+	}
+}
@@ -0,0 +1,355 @@
+#include "UMCP_BlueprintGraphExport.h"
+#include "UnrealMCPServerModule.h"
+
+#include "Algo/Find.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "EdGraphSchema_K2.h"
+#include "Engine/Blueprint.h"
+#include "K2Node_FunctionEntry.h"
+#include "K2Node_FunctionResult.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	using EFields = FUMCP_BlueprintGraphExport::EFields;
+	using FCondensedJsonWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+	struct FFieldName
+	{
+		const TCHAR* Name;
+		EFields Field;
+	};
+
+	const FFieldName FieldNames[] = {
+		{ TEXT("variables"), EFields::Variables },
+		{ TEXT("functions"), EFields::Functions },
+		{ TEXT("graphs"), EFields::Graphs },
+		{ TEXT("nodes"), EFields::Nodes },
+		{ TEXT("pins"), EFields::Pins },
+		{ TEXT("links"), EFields::Links },
+		{ TEXT("defaults"), EFields::Defaults },
+		{ TEXT("comments"), EFields::Comments },
+		{ TEXT("positions"), EFields::Positions },
+	};
+
+	FString GetPinTypeName(const FEdGraphPinType& PinType)
+	{
+		return UEdGraphSchema_K2::TypeToText(PinType).ToString();
+	}
+
+	bool IsExecPin(const UEdGraphPin& Pin)
+	{
+		return Pin.PinType.PinCategory == UEdGraphSchema_K2::PC_Exec;
+	}
+
+	class FGraphWriter
+	{
+	public:
+		FGraphWriter(FCondensedJsonWriter& InWriter, EFields InFields)
+			: Writer(InWriter)
+			, Fields(InFields)
+		{
+		}
+
+		void WriteVariables(const UBlueprint& Blueprint)
+		{
+			Writer.WriteArrayStart(TEXT("variables"));
+			for (const FBPVariableDescription& Variable : Blueprint.NewVariables)
+			{
+				Writer.WriteObjectStart();
+				Writer.WriteValue(TEXT("name"), Variable.VarName.ToString());
+				Writer.WriteValue(TEXT("type"), GetPinTypeName(Variable.VarType));
+				if (!Variable.Category.IsEmpty() && !Variable.Category.EqualTo(UEdGraphSchema_K2::VR_DefaultCategory))
+				{
+					Writer.WriteValue(TEXT("category"), Variable.Category.ToString());
+				}
+				if (EnumHasAnyFlags(Fields, EFields::Defaults) && !Variable.DefaultValue.IsEmpty())
+				{
+					Writer.WriteValue(TEXT("default"), Variable.DefaultValue);
+				}
+				Writer.WriteObjectEnd();
+			}
+			Writer.WriteArrayEnd();
+		}
+
+		void WriteFunctions(const UBlueprint& Blueprint)
+		{
+			Writer.WriteArrayStart(TEXT("functions"));
+			for (const UEdGraph* Graph : Blueprint.FunctionGraphs)
+			{
+				if (!Graph)
+				{
+					continue;
+				}
+				Writer.WriteObjectStart();
+				Writer.WriteValue(TEXT("name"), Graph->GetName());
+				// The entry node's outputs are the parameters, the result node's inputs the return values
+				Writer.WriteArrayStart(TEXT("inputs"));
+				for (const UEdGraphNode* Node : Graph->Nodes)
+				{
+					if (Node && Node->IsA<UK2Node_FunctionEntry>())
+					{
+						WriteSignaturePins(*Node, EGPD_Output);
+					}
+				}
+				Writer.WriteArrayEnd();
+				Writer.WriteArrayStart(TEXT("outputs"));
+				for (const UEdGraphNode* Node : Graph->Nodes)
+				{
+					// Functions with several return nodes repeat the same pins on each, one is enough
+					if (Node && Node->IsA<UK2Node_FunctionResult>())
+					{
+						WriteSignaturePins(*Node, EGPD_Input);
+						break;
+					}
+				}
+				Writer.WriteArrayEnd();
+				Writer.WriteObjectEnd();
+			}
+			Writer.WriteArrayEnd();
+		}
+
+		void WriteGraphs(const UBlueprint& Blueprint)
+		{
+			Writer.WriteArrayStart(TEXT("graphs"));
+			WriteGraphList(Blueprint.UbergraphPages, TEXT("event"));
+			WriteGraphList(Blueprint.FunctionGraphs, TEXT("function"));
+			WriteGraphList(Blueprint.MacroGraphs, TEXT("macro"));
+			WriteGraphList(Blueprint.DelegateSignatureGraphs, TEXT("delegate"));
+			Writer.WriteArrayEnd();
+		}
+
+	private:
+		void WriteSignaturePins(const UEdGraphNode& Node, EEdGraphPinDirection Direction)
+		{
+			for (const UEdGraphPin* Pin : Node.Pins)
+			{
+				if (Pin && Pin->Direction == Direction && !IsExecPin(*Pin) && !Pin->bHidden)
+				{
+					Writer.WriteObjectStart();
+					Writer.WriteValue(TEXT("name"), Pin->PinName.ToString());
+					Writer.WriteValue(TEXT("type"), GetPinTypeName(Pin->PinType));
+					Writer.WriteObjectEnd();
+				}
+			}
+		}
+
+		void WriteGraphList(const TArray<TObjectPtr<UEdGraph>>& Graphs, const TCHAR* Kind)
+		{
+			for (const UEdGraph* Graph : Graphs)
+			{
+				if (Graph)
+				{
+					WriteGraph(*Graph, Kind, Graph->GetName());
+				}
+			}
+		}
+
+		// Collapsed graphs follow the graph they are in, named by their path from it
+		void WriteGraph(const UEdGraph& Graph, const TCHAR* Kind, const FString& Name)
+		{
+			Writer.WriteObjectStart();
+			Writer.WriteValue(TEXT("name"), Name);
+			Writer.WriteValue(TEXT("kind"), FString(Kind));
+			if (EnumHasAnyFlags(Fields, EFields::Nodes))
+			{
+				WriteNodes(Graph);
+			}
+			Writer.WriteObjectEnd();
+
+			for (const UEdGraph* SubGraph : Graph.SubGraphs)
+			{
+				if (SubGraph)
+				{
+					WriteGraph(*SubGraph, TEXT("collapsed"), Name + TEXT("/") + SubGraph->GetName());
+				}
+			}
+		}
+
+		void WriteNodes(const UEdGraph& Graph)
+		{
+			// Ids are positions in this graph's node list, links refer to them
+			TMap<const UEdGraphNode*, int32> NodeIds;
+			NodeIds.Reserve(Graph.Nodes.Num());
+			Writer.WriteArrayStart(TEXT("nodes"));
+			for (const UEdGraphNode* Node : Graph.Nodes)
+			{
+				if (!Node)
+				{
+					continue;
+				}
+				const int32 NodeId = NodeIds.Num();
+				NodeIds.Add(Node, NodeId);
+
+				Writer.WriteObjectStart();
+				Writer.WriteValue(TEXT("id"), NodeId);
+				FString ClassName = Node->GetClass()->GetName();
+				ClassName.RemoveFromStart(TEXT("K2Node_"));
+				Writer.WriteValue(TEXT("class"), ClassName);
+				Writer.WriteValue(TEXT("title"), Node->GetNodeTitle(ENodeTitleType::ListView).ToString());
+				if (EnumHasAnyFlags(Fields, EFields::Comments) && !Node->NodeComment.IsEmpty())
+				{
+					Writer.WriteValue(TEXT("comment"), Node->NodeComment);
+				}
+				if (EnumHasAnyFlags(Fields, EFields::Positions))
+				{
+					Writer.WriteArrayStart(TEXT("pos"));
+					Writer.WriteValue(Node->NodePosX);
+					Writer.WriteValue(Node->NodePosY);
+					Writer.WriteArrayEnd();
+				}
+				if (EnumHasAnyFlags(Fields, EFields::Pins))
+				{
+					WritePins(*Node);
+				}
+				Writer.WriteObjectEnd();
+			}
+			Writer.WriteArrayEnd();
+
+			if (EnumHasAnyFlags(Fields, EFields::Links))
+			{
+				WriteLinks(Graph, NodeIds);
+			}
+		}
+
+		void WritePins(const UEdGraphNode& Node)
+		{
+			Writer.WriteArrayStart(TEXT("pins"));
+			for (const UEdGraphPin* Pin : Node.Pins)
+			{
+				// Hidden pins only matter when something is wired to them
+				if (!Pin || (Pin->bHidden && Pin->LinkedTo.IsEmpty()))
+				{
+					continue;
+				}
+				Writer.WriteObjectStart();
+				Writer.WriteValue(TEXT("name"), Pin->PinName.ToString());
+				Writer.WriteValue(TEXT("dir"), FString(Pin->Direction == EGPD_Input ? TEXT("in") : TEXT("out")));
+				Writer.WriteValue(TEXT("type"), IsExecPin(*Pin) ? FString(TEXT("exec")) : GetPinTypeName(Pin->PinType));
+				if (EnumHasAnyFlags(Fields, EFields::Defaults) && Pin->Direction == EGPD_Input && Pin->LinkedTo.IsEmpty())
+				{
+					const FString DefaultValue = Pin->GetDefaultAsString();
+					if (!DefaultValue.IsEmpty())
+					{
+						Writer.WriteValue(TEXT("default"), DefaultValue);
+					}
+				}
+				Writer.WriteObjectEnd();
+			}
+			Writer.WriteArrayEnd();
+		}
+
+		// [from node, from pin, to node, to pin], following links out of output pins so each is listed once
+		void WriteLinks(const UEdGraph& Graph, const TMap<const UEdGraphNode*, int32>& NodeIds)
+		{
+			Writer.WriteArrayStart(TEXT("links"));
+			for (const UEdGraphNode* Node : Graph.Nodes)
+			{
+				if (!Node)
+				{
+					continue;
+				}
+				const int32 FromId = NodeIds.FindChecked(Node);
+				for (const UEdGraphPin* Pin : Node->Pins)
+				{
+					if (!Pin || Pin->Direction != EGPD_Output)
+					{
+						continue;
+					}
+					for (const UEdGraphPin* LinkedPin : Pin->LinkedTo)
+					{
+						const int32* ToId = LinkedPin ? NodeIds.Find(LinkedPin->GetOwningNodeUnchecked()) : nullptr;
+						if (!ToId)
+						{
+							continue;
+						}
+						Writer.WriteArrayStart();
+						Writer.WriteValue(FromId);
+						Writer.WriteValue(Pin->PinName.ToString());
+						Writer.WriteValue(*ToId);
+						Writer.WriteValue(LinkedPin->PinName.ToString());
+						Writer.WriteArrayEnd();
+					}
+				}
+			}
+			Writer.WriteArrayEnd();
+		}
+
+		FCondensedJsonWriter& Writer;
+		EFields Fields;
+	};
+}
+
+bool FUMCP_BlueprintGraphExport::ParseFields(TConstArrayView<FString> Names, EFields& OutFields, FString& OutError)
+{
+	if (Names.IsEmpty())
+	{
+		OutFields = EFields::Default;
+		return true;
+	}
+
+	OutFields = EFields::None;
+	for (const FString& Name : Names)
+	{
+		const FFieldName* Found = Algo::FindByPredicate(FieldNames, [&Name](const FFieldName& Candidate) { return Name.Equals(Candidate.Name, ESearchCase::IgnoreCase); });
+		if (!Found)
+		{
+			OutError = FString::Printf(TEXT("Unknown field: %s"), *Name);
+			return false;
+		}
+		OutFields |= Found->Field;
+	}
+	// Parts of nodes need the nodes, and nodes need their graphs
+	if (EnumHasAnyFlags(OutFields, EFields::Pins | EFields::Links | EFields::Comments | EFields::Positions))
+	{
+		OutFields |= EFields::Nodes;
+	}
+	if (EnumHasAnyFlags(OutFields, EFields::Nodes))
+	{
+		OutFields |= EFields::Graphs;
+	}
+	return true;
+}
+
+bool FUMCP_BlueprintGraphExport::Export(const FString& BlueprintPath, EFields Fields, FString& OutJson)
+{
+	check(IsInGameThread());
+
+	const UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
+	if (!Blueprint)
+	{
+		OutJson = FString::Printf(TEXT("Failed to load Blueprint: %s"), *BlueprintPath);
+		return false;
+	}
+
+	OutJson.Reset();
+	TSharedRef<FCondensedJsonWriter> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutJson);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("blueprint"), Blueprint->GetPathName());
+	if (Blueprint->ParentClass)
+	{
+		Writer->WriteValue(TEXT("parentClass"), Blueprint->ParentClass->GetPathName());
+	}
+
+	FGraphWriter GraphWriter(*Writer, Fields);
+	if (EnumHasAnyFlags(Fields, EFields::Variables))
+	{
+		GraphWriter.WriteVariables(*Blueprint);
+	}
+	if (EnumHasAnyFlags(Fields, EFields::Functions))
+	{
+		GraphWriter.WriteFunctions(*Blueprint);
+	}
+	if (EnumHasAnyFlags(Fields, EFields::Graphs))
+	{
+		GraphWriter.WriteGraphs(*Blueprint);
+	}
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Exported the graphs of Blueprint '%s', %d characters"), *BlueprintPath, OutJson.Len());
+	return true;
+}
@@ -0,0 +1,693 @@
+#include "UMCP_BlueprintIndex.h"
+#include "UMCP_FuzzyMatch.h"
+#include "UnrealMCPServerModule.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Blueprint.h"
+#include "Algo/Sort.h"
+#include "Misc/Base64.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeRWLock.h"
+#include "Modules/ModuleManager.h"
+#include "String/Find.h"
+
+namespace
+{
+	// Below this the search string table isn't worth compacting
+	constexpr int32 MinGarbageCharsToCompact = 64 * 1024;
+	// Scans smaller than this stay on the calling thread
+	constexpr int32 MinItemsPerChunk = 2048;
+
+	// Splits a scan of NumItems into contiguous chunks for the task graph, at most a few per worker
+	int32 GetNumChunks(int32 NumItems)
+	{
+		const int32 MaxChunks = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads()) * 4;
+		return FMath::Clamp(NumItems / MinItemsPerChunk, 1, MaxChunks);
+	}
+
+	// Runs Func(Chunk, Begin, End) over every chunk of [0, NumItems), in parallel when there is more than one
+	template <typename FuncType>
+	void ParallelForChunks(int32 NumItems, int32 NumChunks, FuncType&& Func)
+	{
+		ParallelFor(NumChunks, [NumItems, NumChunks, &Func](int32 Chunk)
+		{
+			const int32 Begin = static_cast<int32>(static_cast<int64>(NumItems) * Chunk / NumChunks);
+			const int32 End = static_cast<int32>(static_cast<int64>(NumItems) * (Chunk + 1) / NumChunks);
+			Func(Chunk, Begin, End);
+		}, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+	}
+
+	// Filter(Index, OutMatches) adds the matches for each item to a buffer of its chunk. The buffers are appended in
+	// chunk order, so OutMatches comes out in item order however the chunks were scheduled.
+	template <typename MatchType, typename FilterType>
+	void ParallelCollect(int32 NumItems, TArray<MatchType>& OutMatches, FilterType&& Filter)
+	{
+		const int32 NumChunks = GetNumChunks(NumItems);
+		TArray<TArray<MatchType>> ChunkMatches;
+		ChunkMatches.SetNum(NumChunks);
+		ParallelForChunks(NumItems, NumChunks, [&ChunkMatches, &Filter](int32 Chunk, int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				Filter(Index, ChunkMatches[Chunk]);
+			}
+		});
+		for (TArray<MatchType>& Matches : ChunkMatches)
+		{
+			OutMatches.Append(MoveTemp(Matches));
+		}
+	}
+
+	bool ContainsLowerCase(FStringView Haystack, FStringView Needle)
+	{
+		return UE::String::FindFirst(Haystack, Needle, ESearchCase::CaseSensitive) != INDEX_NONE;
+	}
+
+	bool IsNativeClassPath(const FString& ClassPath)
+	{
+		return ClassPath.StartsWith(TEXT("/Script/"));
+	}
+}
+
+FUMCP_BlueprintIndex::FUMCP_BlueprintIndex()
+{
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FUMCP_BlueprintIndex::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FUMCP_BlueprintIndex::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FUMCP_BlueprintIndex::OnAssetRenamed);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FUMCP_BlueprintIndex::OnAssetUpdated);
+}
+
+FUMCP_BlueprintIndex::~FUMCP_BlueprintIndex()
+{
+	// The registry may already be gone on shutdown
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+	}
+}
+
+void FUMCP_BlueprintIndex::EnsureBuilt()
+{
+	{
+		FReadScopeLock ReadLock(IndexLock);
+		if (bBuilt)
+		{
+			return;
+		}
+	}
+
+	FScopeLock BuildScopeLock(&BuildLock);
+	{
+		FReadScopeLock ReadLock(IndexLock);
+		if (bBuilt)
+		{
+			return;
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	const FTopLevelAssetPath BlueprintClassPath = UBlueprint::StaticClass()->GetClassPathName();
+	TSet<FTopLevelAssetPath> DerivedClasses;
+	AssetRegistry.GetDerivedClassNames({ BlueprintClassPath }, {}, DerivedClasses);
+	DerivedClasses.Add(BlueprintClassPath);
+	{
+		// From here on registry events are held back until the snapshot below is in
+		FWriteScopeLock WriteLock(IndexLock);
+		BlueprintClasses = MoveTemp(DerivedClasses);
+		bBuilding = true;
+	}
+
+	// Taken outside of our lock, the registry broadcasts its events under its own
+	FARFilter Filter;
+	Filter.ClassPaths = BlueprintClasses.Array();
+	TArray<FAssetData> AssetDataList;
+	AssetRegistry.GetAssets(Filter, AssetDataList);
+
+	FWriteScopeLock WriteLock(IndexLock);
+	Entries.Reserve(AssetDataList.Num());
+	EntryByPath.Reserve(AssetDataList.Num());
+	for (const FAssetData& AssetData : AssetDataList)
+	{
+		AddOrUpdateEntry(AssetData);
+	}
+	for (const FPendingEvent& Event : PendingEvents)
+	{
+		ApplyEvent(Event);
+	}
+	PendingEvents.Empty();
+	bBuilding = false;
+	bBuilt = true;
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("Built the Blueprint index: %d assets, %d classes, %d search characters in %.1f ms."),
+		EntryByPath.Num(), ClassNodes.Num(), SearchChars.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FUMCP_BlueprintIndex::ResolveNativeClasses()
+{
+	{
+		FReadScopeLock ReadLock(IndexLock);
+		if (UnresolvedNativeClasses.IsEmpty())
+		{
+			return;
+		}
+	}
+
+	// Keeps a concurrent search from going ahead before the classes another one took are linked
+	FScopeLock BuildScopeLock(&BuildLock);
+	TArray<int32> Nodes;
+	TArray<FTopLevelAssetPath> ClassPaths;
+	{
+		FWriteScopeLock WriteLock(IndexLock);
+		for (int32 Node : UnresolvedNativeClasses)
+		{
+			FTopLevelAssetPath ClassPath;
+			if (!ClassNodes[Node].bSuperClassKnown && ClassPath.TrySetPath(ClassNodes[Node].Path))
+			{
+				Nodes.Add(Node);
+				ClassPaths.Add(ClassPath);
+			}
+		}
+		UnresolvedNativeClasses.Reset();
+	}
+
+	// Asked outside of our lock, like the initial snapshot
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TArray<TArray<FTopLevelAssetPath>> Ancestors;
+	Ancestors.SetNum(ClassPaths.Num());
+	for (int32 Index = 0; Index < ClassPaths.Num(); ++Index)
+	{
+		AssetRegistry.GetAncestorClassNames(ClassPaths[Index], Ancestors[Index]);
+	}
+
+	FWriteScopeLock WriteLock(IndexLock);
+	for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+	{
+		// Ancestors come nearest first, linking stops at the first one already in the tree
+		int32 Node = Nodes[Index];
+		for (const FTopLevelAssetPath& Ancestor : Ancestors[Index])
+		{
+			if (ClassNodes[Node].bSuperClassKnown)
+			{
+				break;
+			}
+			const int32 SuperNode = FindOrAddClassNode(Ancestor.ToString());
+			SetSuperClass(Node, SuperNode);
+			Node = SuperNode;
+		}
+		// The top of the chain is a root
+		ClassNodes[Node].bSuperClassKnown = true;
+	}
+	// Ancestors linked above were queued as they were added
+	UnresolvedNativeClasses.RemoveAll([this](int32 Node) { return ClassNodes[Node].bSuperClassKnown; });
+}
+
+bool FUMCP_BlueprintIndex::IsBlueprintAsset(const FAssetData& AssetData) const
+{
+	return BlueprintClasses.Contains(AssetData.AssetClassPath);
+}
+
+void FUMCP_BlueprintIndex::OnAssetAdded(const FAssetData& AssetData)
+{
+	QueueOrApply(FPendingEvent{ EEventType::AddedOrUpdated, AssetData.GetSoftObjectPath(), AssetData });
+}
+
+void FUMCP_BlueprintIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+	QueueOrApply(FPendingEvent{ EEventType::Removed, AssetData.GetSoftObjectPath(), FAssetData() });
+}
+
+void FUMCP_BlueprintIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	QueueOrApply(FPendingEvent{ EEventType::Removed, FSoftObjectPath(OldObjectPath), FAssetData() });
+	QueueOrApply(FPendingEvent{ EEventType::AddedOrUpdated, AssetData.GetSoftObjectPath(), AssetData });
+}
+
+void FUMCP_BlueprintIndex::OnAssetUpdated(const FAssetData& AssetData)
+{
+	QueueOrApply(FPendingEvent{ EEventType::AddedOrUpdated, AssetData.GetSoftObjectPath(), AssetData });
+}
+
+void FUMCP_BlueprintIndex::QueueOrApply(FPendingEvent&& Event)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	// Until the first search there is nothing to keep current
+	if (bBuilt)
+	{
+		ApplyEvent(Event);
+	}
+	else if (bBuilding)
+	{
+		PendingEvents.Add(MoveTemp(Event));
+	}
+	// Only after the change is in, a search that saw the old generation may not have seen it
+	Generation.fetch_add(1, std::memory_order_release);
+}
+
+void FUMCP_BlueprintIndex::ApplyEvent(const FPendingEvent& Event)
+{
+	if (Event.Type == EEventType::Removed)
+	{
+		RemoveEntry(Event.AssetPath);
+	}
+	else if (IsBlueprintAsset(Event.AssetData))
+	{
+		AddOrUpdateEntry(Event.AssetData);
+	}
+}
+
+void FUMCP_BlueprintIndex::AddOrUpdateEntry(const FAssetData& AssetData)
+{
+	const FSoftObjectPath AssetPath = AssetData.GetSoftObjectPath();
+	int32 EntryIndex = INDEX_NONE;
+	if (const int32* ExistingIndex = EntryByPath.Find(AssetPath))
+	{
+		EntryIndex = *ExistingIndex;
+		UnindexEntry(EntryIndex);
+		GarbageChars += Entries[EntryIndex].SearchName.Length + Entries[EntryIndex].SearchPackagePath.Length;
+	}
+	else
+	{
+		EntryIndex = FreeEntries.Num() > 0 ? FreeEntries.Pop() : Entries.AddDefaulted();
+		EntryByPath.Add(AssetPath, EntryIndex);
+	}
+
+	// Both tags are export text paths, e.g. /Script/CoreUObject.Class'/Script/Engine.Actor'
+	FString ParentClass;
+	AssetData.GetTagValue(FBlueprintTags::ParentClassPath, ParentClass);
+	FString GeneratedClass;
+	AssetData.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClass);
+	GeneratedClass = GeneratedClass.IsEmpty() ? AssetPath.ToString() + TEXT("_C") : FPackageName::ExportTextPathToObjectPath(GeneratedClass);
+
+	const int32 ClassNode = FindOrAddClassNode(GeneratedClass);
+	const int32 ParentClassNode = ParentClass.IsEmpty() ? INDEX_NONE : FindOrAddClassNode(FPackageName::ExportTextPathToObjectPath(ParentClass));
+
+	FEntry& Entry = Entries[EntryIndex];
+	Entry.AssetPath = AssetPath;
+	Entry.AssetName = AssetData.AssetName;
+	Entry.PackagePath = AssetData.PackagePath;
+	Entry.SearchName = AddSearchString(AssetData.AssetName.ToString());
+	Entry.SearchPackagePath = AddSearchString(AssetData.PackagePath.ToString());
+	Entry.ClassNode = ClassNode;
+	Entry.bLive = true;
+	IndexEntry(EntryIndex);
+	SetSuperClass(ClassNode, ParentClassNode);
+
+	if (GarbageChars > MinGarbageCharsToCompact && GarbageChars > SearchChars.Num() / 2)
+	{
+		CompactSearchChars();
+	}
+}
+
+void FUMCP_BlueprintIndex::RemoveEntry(const FSoftObjectPath& AssetPath)
+{
+	int32 EntryIndex = INDEX_NONE;
+	if (!EntryByPath.RemoveAndCopyValue(AssetPath, EntryIndex))
+	{
+		return;
+	}
+	UnindexEntry(EntryIndex);
+	FEntry& Entry = Entries[EntryIndex];
+	GarbageChars += Entry.SearchName.Length + Entry.SearchPackagePath.Length;
+	Entry = FEntry();
+	FreeEntries.Add(EntryIndex);
+}
+
+void FUMCP_BlueprintIndex::IndexEntry(int32 EntryIndex)
+{
+	const FEntry& Entry = Entries[EntryIndex];
+	NameTrigrams.Add(EntryIndex, GetSearchString(Entry.SearchName));
+	ClassNodes[Entry.ClassNode].BlueprintEntry = EntryIndex;
+}
+
+void FUMCP_BlueprintIndex::UnindexEntry(int32 EntryIndex)
+{
+	const FEntry& Entry = Entries[EntryIndex];
+	NameTrigrams.Remove(EntryIndex, GetSearchString(Entry.SearchName));
+	// The node stays for the classes deriving from it, but it no longer has a Blueprint or a known parent
+	if (ClassNodes[Entry.ClassNode].BlueprintEntry == EntryIndex)
+	{
+		ClassNodes[Entry.ClassNode].BlueprintEntry = INDEX_NONE;
+		SetSuperClass(Entry.ClassNode, INDEX_NONE);
+	}
+}
+
+FUMCP_BlueprintIndex::FCharSpan FUMCP_BlueprintIndex::AddSearchString(FStringView Text)
+{
+	FCharSpan Span;
+	Span.Offset = SearchChars.Num();
+	Span.Length = Text.Len();
+	for (TCHAR Char : Text)
+	{
+		SearchChars.Add(FChar::ToLower(Char));
+	}
+	return Span;
+}
+
+
+void FUMCP_BlueprintIndex::CompactSearchChars()
+{
+	TArray<TCHAR> OldChars = MoveTemp(SearchChars);
+	SearchChars.Reset(OldChars.Num() - GarbageChars);
+	auto MoveSpan = [this, &OldChars](FCharSpan& Span)
+	{
+		const int32 NewOffset = SearchChars.Num();
+		SearchChars.Append(OldChars.GetData() + Span.Offset, Span.Length);
+		Span.Offset = NewOffset;
+	};
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.bLive)
+		{
+			MoveSpan(Entry.SearchName);
+			MoveSpan(Entry.SearchPackagePath);
+		}
+	}
+	GarbageChars = 0;
+}
+
+int32 FUMCP_BlueprintIndex::FindOrAddClassNode(const FString& ClassPath)
+{
+	if (const int32* ExistingNode = ClassNodeIds.Find(ClassPath))
+	{
+		return *ExistingNode;
+	}
+	const int32 Node = ClassNodes.AddDefaulted();
+	ClassNodes[Node].Path = ClassPath;
+	ClassNodeIds.Add(ClassPath, Node);
+
+	FString ClassName;
+	if (!ClassPath.Split(TEXT("."), nullptr, &ClassName, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		ClassName = ClassPath;
+	}
+	ClassNodesByName.Add(ClassName, Node);
+	if (IsNativeClassPath(ClassPath))
+	{
+		UnresolvedNativeClasses.Add(Node);
+	}
+	else if (ClassName.RemoveFromEnd(TEXT("_C"), ESearchCase::CaseSensitive))
+	{
+		// So the Blueprint's own name finds its class
+		ClassNodesByName.Add(ClassName, Node);
+	}
+	return Node;
+}
+
+void FUMCP_BlueprintIndex::SetSuperClass(int32 Node, int32 SuperNode)
+{
+	FClassNode& Class = ClassNodes[Node];
+	if (Class.SuperClass != INDEX_NONE)
+	{
+		ClassNodes[Class.SuperClass].SubClasses.RemoveSingleSwap(Node);
+	}
+	Class.SuperClass = SuperNode;
+	Class.bSuperClassKnown = SuperNode != INDEX_NONE;
+	if (SuperNode != INDEX_NONE)
+	{
+		ClassNodes[SuperNode].SubClasses.Add(Node);
+	}
+}
+
+void FUMCP_BlueprintIndex::CollectDerivedEntries(const FString& ClassTerm, int32 MaxDepth, TArray<TPair<int32, int32>>& OutEntries) const
+{
+	// Paths and names compare case-insensitively as map keys
+	TArray<int32> Level;
+	const FString ClassPath = FPackageName::ExportTextPathToObjectPath(ClassTerm);
+	if (const int32* Node = ClassNodeIds.Find(ClassPath))
+	{
+		Level.Add(*Node);
+	}
+	else
+	{
+		ClassNodesByName.MultiFind(ClassPath, Level);
+	}
+
+	// Breadth first, so a class reachable from two of the roots gets the shorter depth
+	TBitArray<> Visited(false, ClassNodes.Num());
+	for (int32 Node : Level)
+	{
+		Visited[Node] = true;
+	}
+	TArray<int32> NextLevel;
+	for (int32 Depth = 1; !Level.IsEmpty() && (MaxDepth <= 0 || Depth <= MaxDepth); ++Depth)
+	{
+		NextLevel.Reset();
+		for (int32 Node : Level)
+		{
+			for (int32 SubClass : ClassNodes[Node].SubClasses)
+			{
+				if (Visited[SubClass])
+				{
+					continue;
+				}
+				Visited[SubClass] = true;
+				NextLevel.Add(SubClass);
+				if (ClassNodes[SubClass].BlueprintEntry != INDEX_NONE)
+				{
+					OutEntries.Emplace(ClassNodes[SubClass].BlueprintEntry, Depth);
+				}
+			}
+		}
+		Swap(Level, NextLevel);
+	}
+	Algo::SortBy(OutEntries, &TPair<int32, int32>::Key);
+}
+
+int32 FUMCP_BlueprintIndex::CompareEntryKey(const FEntry& Entry, FStringView PackagePath, FStringView AssetName) const
+{
+	const int32 PackageOrder = GetSearchString(Entry.SearchPackagePath).Compare(PackagePath, ESearchCase::CaseSensitive);
+	return PackageOrder != 0 ? PackageOrder : GetSearchString(Entry.SearchName).Compare(AssetName, ESearchCase::CaseSensitive);
+}
+
+bool FUMCP_BlueprintIndex::Search(const FQuery& Query, FResults& OutResults)
+{
+	// The cursor is the sort key of the last hit handed out
+	FString CursorPackagePath;
+	FString CursorAssetName;
+	int32 CursorScore = 0;
+	if (!Query.Cursor.IsEmpty())
+	{
+		FString DecodedCursor;
+		TArray<FString> CursorParts;
+		if (!FBase64::Decode(Query.Cursor, DecodedCursor) || DecodedCursor.ParseIntoArray(CursorParts, TEXT("\n"), false) != 3
+			|| !LexTryParseString(CursorScore, *CursorParts[2]))
+		{
+			return false;
+		}
+		CursorPackagePath = MoveTemp(CursorParts[0]);
+		CursorAssetName = MoveTemp(CursorParts[1]);
+	}
+
+	EnsureBuilt();
+	ResolveNativeClasses();
+
+	const FString NameTerm = Query.NameTerm.ToLower();
+	FString PackagePath = Query.PackagePath.ToLower();
+	PackagePath.RemoveFromEnd(TEXT("/"));
+	const FString PackagePathPrefix = PackagePath + TEXT("/");
+
+	// Held across the parallel scans below, the workers read under it too
+	FReadScopeLock ReadLock(IndexLock);
+
+	// Both lists end up sorted by entry id
+	TArray<int32> NameMatches;
+	if (!NameTerm.IsEmpty())
+	{
+		TArray<int32> Candidates;
+		if (NameTrigrams.FindCandidates(NameTerm, Candidates))
+		{
+			ParallelCollect(Candidates.Num(), NameMatches, [this, &Candidates, &NameTerm](int32 Index, TArray<int32>& OutMatches)
+			{
+				const FEntry& Entry = Entries[Candidates[Index]];
+				if (Entry.bLive && ContainsLowerCase(GetSearchString(Entry.SearchName), NameTerm))
+				{
+					OutMatches.Add(Candidates[Index]);
+				}
+			});
+		}
+		else
+		{
+			// Too short for trigrams, every entry is a candidate
+			ParallelCollect(Entries.Num(), NameMatches, [this, &NameTerm](int32 EntryIndex, TArray<int32>& OutMatches)
+			{
+				const FEntry& Entry = Entries[EntryIndex];
+				if (Entry.bLive && ContainsLowerCase(GetSearchString(Entry.SearchName), NameTerm))
+				{
+					OutMatches.Add(EntryIndex);
+				}
+			});
+		}
+	}
+
+	// Entry and depth
+	TArray<TPair<int32, int32>> ParentClassMatches;
+	if (!Query.ParentClassTerm.IsEmpty())
+	{
+		CollectDerivedEntries(Query.ParentClassTerm, Query.MaxDepth, ParentClassMatches);
+	}
+
+	struct FMatch
+	{
+		int32 EntryIndex;
+		bool bNameMatch;
+		bool bParentClassMatch;
+		int32 Depth;
+		int32 Score;
+	};
+	// Only the page is ever sorted, the rest of the hits are just counted
+	auto IsBefore = [this](const FMatch& A, const FMatch& B)
+	{
+		if (A.Score != B.Score)
+		{
+			return A.Score > B.Score;
+		}
+		const FEntry& EntryB = Entries[B.EntryIndex];
+		return CompareEntryKey(Entries[A.EntryIndex], GetSearchString(EntryB.SearchPackagePath), GetSearchString(EntryB.SearchName)) < 0;
+	};
+	// Heaps keep the least element per predicate on top, so this keeps the last hit of the page there
+	auto IsAfter = [&IsBefore](const FMatch& A, const FMatch& B) { return IsBefore(B, A); };
+
+	// Sorted by entry id as well
+	TArray<FMatch> Matches;
+	if (Query.bAllAssets)
+	{
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			if (Entries[EntryIndex].bLive)
+			{
+				Matches.Add(FMatch{ EntryIndex, false, false, 0, 0 });
+			}
+		}
+	}
+	else if (!Query.FuzzyTerm.IsEmpty())
+	{
+		ParallelCollect(Entries.Num(), Matches, [this, &Query](int32 EntryIndex, TArray<FMatch>& OutMatches)
+		{
+			if (!Entries[EntryIndex].bLive)
+			{
+				return;
+			}
+			// Scored against the name as it is, the word starts are in the casing
+			TStringBuilder<256> AssetName;
+			Entries[EntryIndex].AssetName.AppendString(AssetName);
+			const int32 Score = FUMCP_FuzzyMatch::Score(Query.FuzzyTerm, AssetName);
+			if (Score > 0)
+			{
+				OutMatches.Add(FMatch{ EntryIndex, false, false, 0, Score });
+			}
+		});
+	}
+	else
+	{
+		int32 NameIndex = 0;
+		int32 ParentClassIndex = 0;
+		while (NameIndex < NameMatches.Num() || ParentClassIndex < ParentClassMatches.Num())
+		{
+			const int32 NameId = NameIndex < NameMatches.Num() ? NameMatches[NameIndex] : MAX_int32;
+			const int32 ParentClassId = ParentClassIndex < ParentClassMatches.Num() ? ParentClassMatches[ParentClassIndex].Key : MAX_int32;
+			const int32 Depth = ParentClassId <= NameId ? ParentClassMatches[ParentClassIndex].Value : 0;
+			const FMatch& Match = Matches.Add_GetRef(FMatch{ FMath::Min(NameId, ParentClassId), NameId <= ParentClassId, ParentClassId <= NameId, Depth, 0 });
+			NameIndex += Match.bNameMatch ? 1 : 0;
+			ParentClassIndex += Match.bParentClassMatch ? 1 : 0;
+		}
+	}
+
+	auto AddToPage = [&Query, &IsBefore, &IsAfter](TArray<FMatch>& Page, const FMatch& Match)
+	{
+		if (Query.Limit <= 0 || Page.Num() < Query.Limit)
+		{
+			Page.HeapPush(Match, IsAfter);
+		}
+		else if (IsBefore(Match, Page.HeapTop()))
+		{
+			Page.HeapPopDiscard(IsAfter);
+			Page.HeapPush(Match, IsAfter);
+		}
+	};
+
+	// Each chunk counts its hits and keeps its own best page, the pages are merged after
+	struct FChunkResults
+	{
+		int32 TotalHits = 0;
+		int32 HitsAfterCursor = 0;
+		TArray<FMatch> Page;
+	};
+	const int32 NumChunks = GetNumChunks(Matches.Num());
+	TArray<FChunkResults> ChunkResults;
+	ChunkResults.SetNum(NumChunks);
+	ParallelForChunks(Matches.Num(), NumChunks, [&](int32 Chunk, int32 Begin, int32 End)
+	{
+		FChunkResults& Results = ChunkResults[Chunk];
+		for (int32 MatchIndex = Begin; MatchIndex < End; ++MatchIndex)
+		{
+			const FMatch& Match = Matches[MatchIndex];
+			const FEntry& Entry = Entries[Match.EntryIndex];
+			if (Query.OnlyAssets && !Query.OnlyAssets->Contains(Entry.AssetPath))
+			{
+				continue;
+			}
+			if (!PackagePath.IsEmpty())
+			{
+				const FStringView EntryPackagePath = GetSearchString(Entry.SearchPackagePath);
+				if (EntryPackagePath != PackagePath && (!Query.bRecursivePaths || !EntryPackagePath.StartsWith(PackagePathPrefix, ESearchCase::CaseSensitive)))
+				{
+					continue;
+				}
+			}
+
+			++Results.TotalHits;
+			if (!Query.Cursor.IsEmpty()
+				&& (Match.Score != CursorScore ? Match.Score > CursorScore : CompareEntryKey(Entry, CursorPackagePath, CursorAssetName) <= 0))
+			{
+				continue;
+			}
+			++Results.HitsAfterCursor;
+			AddToPage(Results.Page, Match);
+		}
+	});
+
+	TArray<FMatch> Page;
+	int32 HitsAfterCursor = 0;
+	for (const FChunkResults& Results : ChunkResults)
+	{
+		OutResults.TotalHits += Results.TotalHits;
+		HitsAfterCursor += Results.HitsAfterCursor;
+		for (const FMatch& Match : Results.Page)
+		{
+			AddToPage(Page, Match);
+		}
+	}
+	// Keys are unique, so the order is the same whichever chunk a hit came from
+	Page.Sort(IsBefore);
+	OutResults.Hits.Reserve(Page.Num());
+	for (const FMatch& Match : Page)
+	{
+		const FEntry& Entry = Entries[Match.EntryIndex];
+		FHit& Hit = OutResults.Hits.AddDefaulted_GetRef();
+		Hit.AssetPath = Entry.AssetPath;
+		Hit.AssetName = Entry.AssetName;
+		Hit.PackagePath = Entry.PackagePath;
+		const int32 SuperClass = ClassNodes[Entry.ClassNode].SuperClass;
+		if (SuperClass != INDEX_NONE)
+		{
+			Hit.ParentClass = ClassNodes[SuperClass].Path;
+		}
+		Hit.bNameMatch = Match.bNameMatch;
+		Hit.bParentClassMatch = Match.bParentClassMatch;
+		Hit.Depth = Match.Depth;
+		Hit.Score = Match.Score;
+	}
+	if (HitsAfterCursor > Page.Num() && Page.Num() > 0)
+	{
+		const FEntry& Last = Entries[Page.Last().EntryIndex];
+		OutResults.NextCursor = FBase64::Encode(FString(GetSearchString(Last.SearchPackagePath)) + TEXT("\n")
+			+ FString(GetSearchString(Last.SearchName)) + TEXT("\n") + LexToString(Page.Last().Score));
+	}
+	return true;
+}
@@ -1,10 +1,14 @@
 #include "UMCP_CommonResources.h"
+#include "UMCP_BlueprintGraphExport.h"
 #include "UMCP_Server.h"
 #include "UMCP_Types.h"
 #include "UMCP_UriTemplate.h" // For FUMCP_UriTemplate
 #include "UnrealMCPServerModule.h"
-#include "Engine/Blueprint.h" // Required for UBlueprint
-#include "Exporters/Exporter.h" // Required for UExporter
+
+FUMCP_CommonResources::FUMCP_CommonResources(TSharedRef<FUMCP_T3DExportCache> InExportCache)
+	: ExportCache(MoveTemp(InExportCache))
+{
+}
 
 void FUMCP_CommonResources::Register(class FUMCP_Server* Server)
 {
@@ -14,9 +18,9 @@ void FUMCP_CommonResources::Register(class FUMCP_Server* Server)
 	{
 		FUMCP_ResourceTemplateDefinition T3DTemplateDefinition;
 		T3DTemplateDefinition.name = TEXT("Blueprint T3D Exporter");
-		T3DTemplateDefinition.description = TEXT("Exports the T3D representation of an Unreal Engine Blueprint asset specified by its path using the unreal+t3d://{filepath} URI scheme.");
+		T3DTemplateDefinition.description = TEXT("Exports the T3D representation of an Unreal Engine Blueprint asset specified by its path using the unreal+t3d://{filepath} URI scheme. A second content of type application/json carries the export's version; reading again with ?knownVersion=<version> returns only that content with status notModified, or a text/x-diff against the known version while it is still cached.");
 		T3DTemplateDefinition.mimeType = TEXT("application/vnd.unreal.t3d");
-		T3DTemplateDefinition.uriTemplate = TEXT("unreal+t3d://{filepath}");
+		T3DTemplateDefinition.uriTemplate = TEXT("unreal+t3d://{filepath}{?knownVersion}");
 		// Bind the actual handler for this templated resource
 		T3DTemplateDefinition.ReadResource.BindRaw(this, &FUMCP_CommonResources::HandleT3DResourceRequest);
 
@@ -29,6 +33,24 @@ void FUMCP_CommonResources::Register(class FUMCP_Server* Server)
 			UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to register T3D Blueprint Resource Template."));
 		}
 	}
+
+	{
+		FUMCP_ResourceTemplateDefinition GraphTemplateDefinition;
+		GraphTemplateDefinition.name = TEXT("Blueprint Graph Exporter");
+		GraphTemplateDefinition.description = TEXT("Exports the variables, function signatures and graphs of an Unreal Engine Blueprint asset as compact JSON using the unreal+bpgraph://{filepath} URI scheme. An optional fields query (e.g. ?fields=nodes,links) picks the parts to include.");
+		GraphTemplateDefinition.mimeType = TEXT("application/json");
+		GraphTemplateDefinition.uriTemplate = TEXT("unreal+bpgraph://{filepath}{?fields}");
+		GraphTemplateDefinition.ReadResource.BindRaw(this, &FUMCP_CommonResources::HandleGraphResourceRequest);
+
+		if (Server->RegisterResourceTemplate(MoveTemp(GraphTemplateDefinition)))
+		{
+			UE_LOG(LogUnrealMCPServer, Log, TEXT("Registered Blueprint Graph Resource Template (unreal+bpgraph://{filepath}) for discovery and handling."));
+		}
+		else
+		{
+			UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to register Blueprint Graph Resource Template."));
+		}
+	}
 }
 
 bool FUMCP_CommonResources::HandleT3DResourceRequest(const FUMCP_UriTemplate& UriTemplate, const FUMCP_UriTemplateMatch& Match, TArray<FUMCP_ReadResourceResultContent>& OutContent)
@@ -48,39 +70,79 @@ bool FUMCP_CommonResources::HandleT3DResourceRequest(const FUMCP_UriTemplate& Ur
 	const FString& BlueprintPath = (*FilePathPtr)[0];
 	UE_LOG(LogUnrealMCPServer, Log, TEXT("HandleT3DResourceRequest: Attempting to export Blueprint '%s' from URI '%s'."), *BlueprintPath, *Match.Uri);
 
-	UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
-	if (!Blueprint)
+	FString KnownVersion;
+	if (const TArray<FString>* KnownVersionPtr = Match.Variables.Find(TEXT("knownVersion")); KnownVersionPtr && !KnownVersionPtr->IsEmpty())
+	{
+		KnownVersion = (*KnownVersionPtr)[0];
+	}
+
+	FUMCP_T3DExportCache::FVersionedExport Export;
+	FString Error;
+	if (!ExportCache->ExportSince(BlueprintPath, KnownVersion, Export, Error))
 	{
-		UE_LOG(LogUnrealMCPServer, Warning, TEXT("Failed to load Blueprint: %s"), *BlueprintPath);
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("%s"), *Error);
         Content.mimeType = TEXT("text/plain");
-        Content.text = FString::Printf(TEXT("Error: Failed to load Blueprint: %s"), *BlueprintPath);
+        Content.text = FString::Printf(TEXT("Error: %s"), *Error);
 		return false;
 	}
 
-	UExporter* Exporter = UExporter::FindExporter(Blueprint, TEXT("T3D"));
-	if (!Exporter)
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("Successfully exported Blueprint '%s' to T3D via URI '%s'. Output size: %d"), *BlueprintPath, *Match.Uri, Export.Text.Len());
+	if (Export.Status == FUMCP_T3DExportCache::EExportStatus::NotModified)
 	{
-		UE_LOG(LogUnrealMCPServer, Warning, TEXT("Failed to find T3D exporter for Blueprint: %s"), *BlueprintPath);
-        Content.mimeType = TEXT("text/plain");
-        Content.text = FString::Printf(TEXT("Error: Failed to find T3D exporter for Blueprint: %s"), *BlueprintPath);
+		// Only the version goes back
+		OutContent.Pop();
+	}
+	else
+	{
+		Content.mimeType = Export.Status == FUMCP_T3DExportCache::EExportStatus::Diff ? TEXT("text/x-diff") : TEXT("application/vnd.unreal.t3d");
+		Content.text = MoveTemp(Export.Text);
+	}
+
+	auto& VersionContent = OutContent.AddDefaulted_GetRef();
+	VersionContent.uri = Match.Uri;
+	VersionContent.mimeType = TEXT("application/json");
+	VersionContent.text = Export.GetInfoJson();
+	return true;
+}
+
+bool FUMCP_CommonResources::HandleGraphResourceRequest(const FUMCP_UriTemplate& UriTemplate, const FUMCP_UriTemplateMatch& Match, TArray<FUMCP_ReadResourceResultContent>& OutContent)
+{
+	auto& Content = OutContent.AddDefaulted_GetRef();
+	Content.uri = Match.Uri;
+
+	const TArray<FString>* FilePathPtr = Match.Variables.Find(TEXT("filepath"));
+	if (!FilePathPtr || FilePathPtr->IsEmpty() || (*FilePathPtr)[0].IsEmpty())
+	{
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("HandleGraphResourceRequest: 'filepath' not found in URI '%s' after matching template '%s'."), *Match.Uri, *UriTemplate.GetUriTemplateStr());
+		Content.mimeType = TEXT("text/plain");
+		Content.text = TEXT("Error: Missing 'filepath' parameter in URI.");
 		return false;
 	}
 
-	FStringOutputDevice OutputDevice;
-	const uint32 ExportFlags = PPF_Copy | PPF_ExportsNotFullyQualified;
-	Exporter->ExportText(nullptr, Blueprint, TEXT("T3D"), OutputDevice, GWarn, ExportFlags);
+	// fields=nodes,links arrives as one value
+	TArray<FString> FieldNames;
+	if (const TArray<FString>* FieldsPtr = Match.Variables.Find(TEXT("fields")))
+	{
+		for (const FString& FieldList : *FieldsPtr)
+		{
+			TArray<FString> ListNames;
+			FieldList.ParseIntoArray(ListNames, TEXT(","));
+			FieldNames.Append(MoveTemp(ListNames));
+		}
+	}
 
-	if (OutputDevice.IsEmpty())
+	const FString& BlueprintPath = (*FilePathPtr)[0];
+	FUMCP_BlueprintGraphExport::EFields Fields = FUMCP_BlueprintGraphExport::EFields::Default;
+	FString ExportJson;
+	if (!FUMCP_BlueprintGraphExport::ParseFields(FieldNames, Fields, ExportJson) || !FUMCP_BlueprintGraphExport::Export(BlueprintPath, Fields, ExportJson))
 	{
-		UE_LOG(LogUnrealMCPServer, Warning, TEXT("ExportText did not produce any output for Blueprint: %s. Using exporter: %s."), *BlueprintPath, *Exporter->GetClass()->GetName());
-        Content.mimeType = TEXT("text/plain");
-        Content.text = FString::Printf(TEXT("Error: ExportText did not produce any output for Blueprint: %s."), *BlueprintPath);
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("%s"), *ExportJson);
+		Content.mimeType = TEXT("text/plain");
+		Content.text = FString::Printf(TEXT("Error: %s"), *ExportJson);
 		return false;
 	}
 
-	Content.mimeType = TEXT("application/vnd.unreal.t3d");
-	Content.text = OutputDevice;
-	
-	UE_LOG(LogUnrealMCPServer, Log, TEXT("Successfully exported Blueprint '%s' to T3D via URI '%s'. Output size: %d"), *BlueprintPath, *Match.Uri, Content.text.Len());
+	Content.mimeType = TEXT("application/json");
+	Content.text = MoveTemp(ExportJson);
 	return true;
 }
@@ -1,15 +1,36 @@
 ﻿#include "UMCP_CommonTools.h"
+#include "UMCP_BatchT3DExport.h"
+#include "UMCP_BlueprintContentSearch.h"
+#include "UMCP_BlueprintGraphExport.h"
 #include "UMCP_Server.h"
 #include "UMCP_Types.h"
+#include "UMCP_RequestContext.h"
+#include "UMCP_StreamedText.h"
 #include "UnrealMCPServerModule.h"
-#include "Exporters/Exporter.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Engine/Blueprint.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/PackageName.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
 #include "BlueprintGraph/Classes/K2Node.h"
 
 
 namespace
 {
+	// Keeps a Blueprint matching everywhere from drowning out the rest of the page
+	constexpr int32 MaxContentMatchesPerBlueprint = 20;
+	constexpr int32 MaxCachedSearches = 128;
+
+	TAutoConsoleVariable<int32> CVarT3DExportChunkChars(
+		TEXT("UMCP.T3DExport.ChunkChars"),
+		64 * 1024,
+		TEXT("Characters of text in each partial result of a streamed T3D export."));
+
+	TAutoConsoleVariable<int32> CVarT3DExportStreamMaxPendingKB(
+		TEXT("UMCP.T3DExport.StreamMaxPendingKB"),
+		1024,
+		TEXT("How much of a streamed T3D export may wait on the event stream for the client to pick it up before sending pauses."));
+
 	TSharedPtr<FJsonObject> FromJsonStr(const FString& Str)
 	{
 		TSharedPtr<FJsonObject> RootJsonObject;
@@ -26,13 +47,20 @@ namespace
 }
 
 
+FUMCP_CommonTools::FUMCP_CommonTools(TSharedRef<FUMCP_T3DExportCache> InExportCache)
+	: ExportCache(MoveTemp(InExportCache))
+{
+}
+
 void FUMCP_CommonTools::Register(class FUMCP_Server* Server)
 {
+	GameThreadScheduler = Server->GetGameThreadScheduler();
+
 	{
 		FUMCP_ToolDefinition Tool;
 		Tool.name = TEXT("export_blueprint_to_t3d");
-		Tool.description = TEXT("Export a blueprint's contents to T3D format.");
-		Tool.DoToolCall.BindRaw(this, &FUMCP_CommonTools::ExportBlueprintToT3D);
+		Tool.description = TEXT("Export a blueprint's contents to T3D format. The text is followed by a JSON object with its version; pass that back as knownVersion to get a not-modified status with no text, or a unified diff against it while it is still cached. With stream set and a client listening for notifications, the text arrives in partial results, sent as fast as the client reads them, and the final text is empty.");
+		Tool.DoToolCallAsync.BindRaw(this, &FUMCP_CommonTools::ExportBlueprintToT3D);
 		Tool.inputSchema = FromJsonStr(TEXT(R"({
 			"type": "object",
 			"properties": {
@@ -40,6 +68,17 @@ void FUMCP_CommonTools::Register(class FUMCP_Server* Server)
 					"name": "BlueprintPath",
 					"description": "The path to the blueprint to export",
 					"type": "string"
+				},
+				"stream": {
+					"name": "stream",
+					"description": "Send the text, or the diff with knownVersion, in chunks as partial results, so a large export can be read as it arrives.",
+					"type": "boolean",
+					"default": false
+				},
+				"knownVersion": {
+					"name": "knownVersion",
+					"description": "Version of the export the client already has, from an earlier call",
+					"type": "string"
 				}
 			},
 			"required": ["BlueprintPath"]
@@ -48,21 +87,48 @@ void FUMCP_CommonTools::Register(class FUMCP_Server* Server)
 	}
 	
 	{
+		FUMCP_ToolDefinition Tool;
+		Tool.name = TEXT("export_blueprint_graph");
+		Tool.description = TEXT("Export a blueprint's variables, function signatures and graphs (nodes, pins and links) as compact JSON. Much smaller than T3D; use fields to pick only the parts needed.");
+		Tool.DoToolCall.BindRaw(this, &FUMCP_CommonTools::ExportBlueprintGraph);
+		Tool.inputSchema = FromJsonStr(TEXT(R"({
+			"type": "object",
+			"properties": {
+				"BlueprintPath": {
+					"type": "string",
+					"description": "The path to the blueprint to export"
+				},
+				"fields": {
+					"type": "array",
+					"items": { "type": "string", "enum": ["variables", "functions", "graphs", "nodes", "pins", "links", "defaults", "comments", "positions"] },
+					"description": "Parts to include. Nodes, pins and links bring in the graphs they are in. Defaults to everything but positions."
+				}
+			},
+			"required": ["BlueprintPath"]
+		})"));
+		Server->RegisterTool(MoveTemp(Tool));
+	}
+
+	{
+		BlueprintIndex = MakeUnique<FUMCP_BlueprintIndex>();
+
 		FUMCP_ToolDefinition Tool;
 		Tool.name = TEXT("search_blueprints");
 		Tool.description = TEXT("Search for Blueprint assets based on various criteria including name patterns, parent classes, and package paths.");
 		Tool.DoToolCall.BindRaw(this, &FUMCP_CommonTools::SearchBlueprints);
+		// The Blueprint index can be queried from any thread, so searches stay off the game thread
+		Tool.ThreadAffinity = EUMCP_ThreadAffinity::WorkerPool;
 		Tool.inputSchema = FromJsonStr(TEXT(R"({
 			"type": "object",
 			"properties": {
 				"searchType": {
 					"type": "string",
-					"enum": ["name", "parent_class", "all"],
-					"description": "Type of search to perform: 'name' for name pattern matching, 'parent_class' for finding Blueprint subclasses, 'all' for comprehensive search"
+					"enum": ["name", "parent_class", "all", "content", "fuzzy"],
+					"description": "Type of search to perform: 'name' for name pattern matching, 'parent_class' for finding Blueprints deriving from a class at any depth, 'all' for comprehensive search, 'content' for the graphs, nodes, pins and variables inside Blueprints, 'fuzzy' for misspelled or abbreviated names (e.g. 'PlyrCtrl'), best match first with a score"
 				},
 				"searchTerm": {
 					"type": "string",
-					"description": "Search term (Blueprint name pattern, parent class name, etc.)."
+					"description": "Search term (Blueprint name pattern, parent class name or path, etc.)."
 				},
 				"packagePath": {
 					"type": "string",
@@ -71,12 +137,97 @@ void FUMCP_CommonTools::Register(class FUMCP_Server* Server)
 				"recursive": {
 					"type": "boolean",
 					"description": "Whether to search recursively in subfolders. Defaults to true."
+				},
+				"maxDepth": {
+					"type": "integer",
+					"description": "For parent_class searches, how many levels of subclasses to include. 1 for direct subclasses only; defaults to all."
+				},
+				"limit": {
+					"type": "integer",
+					"description": "Maximum number of results to return. Defaults to 50, at most 500."
+				},
+				"cursor": {
+					"type": "string",
+					"description": "nextCursor from a previous response with the same criteria, to fetch the page after it."
 				}
 			},
 			"required": ["searchType", "searchTerm"]
 		})"));
 		Server->RegisterTool(MoveTemp(Tool));
 	}
+
+	{
+		FUMCP_ToolDefinition Tool;
+		Tool.name = TEXT("query_asset_references");
+		Tool.description = TEXT("List what assets depend on (dependencies) or what depends on them (referencers), following references up to a depth. Returns a node list and a compact edge list.");
+		Tool.DoToolCall.BindRaw(this, &FUMCP_CommonTools::QueryAssetReferences);
+		// The asset registry can be queried from any thread
+		Tool.ThreadAffinity = EUMCP_ThreadAffinity::WorkerPool;
+		Tool.inputSchema = FromJsonStr(TEXT(R"({
+			"type": "object",
+			"properties": {
+				"assets": {
+					"type": "array",
+					"items": { "type": "string" },
+					"description": "Package or object paths of the assets to start from (e.g. '/Game/Blueprints/BP_Player')."
+				},
+				"direction": {
+					"type": "string",
+					"enum": ["dependencies", "referencers"],
+					"description": "'dependencies' for what the assets reference, 'referencers' for what references them. Defaults to dependencies."
+				},
+				"maxDepth": {
+					"type": "integer",
+					"description": "How many references away from the starting assets to go. Defaults to 1, at most 16."
+				},
+				"categories": {
+					"type": "array",
+					"items": { "type": "string", "enum": ["package", "manage", "searchable_name"] },
+					"description": "Kinds of references to follow. Defaults to package references only."
+				},
+				"hardOnly": {
+					"type": "boolean",
+					"description": "Only follow hard package references, skipping soft ones. Defaults to false."
+				},
+				"maxNodes": {
+					"type": "integer",
+					"description": "Stops adding assets after this many. Defaults to 1000, at most 20000."
+				}
+			},
+			"required": ["assets"]
+		})"));
+		Server->RegisterTool(MoveTemp(Tool));
+	}
+
+	{
+		FUMCP_ToolDefinition Tool;
+		Tool.name = TEXT("export_blueprints_to_t3d");
+		Tool.description = TEXT("Export several Blueprints to T3D format at once, loading them in the background. Each result starts with the Blueprint path on its own line, followed by its T3D or an error, in the order the exports finish. A summary comes first.");
+		Tool.DoToolCallAsync.BindRaw(this, &FUMCP_CommonTools::ExportBlueprintsToT3D);
+		Tool.inputSchema = FromJsonStr(TEXT(R"({
+			"type": "object",
+			"properties": {
+				"blueprintPaths": {
+					"type": "array",
+					"items": { "type": "string" },
+					"description": "Object paths of the Blueprints to export (e.g. '/Game/Blueprints/BP_Player.BP_Player')."
+				},
+				"pathPattern": {
+					"type": "string",
+					"description": "Wildcard matched against the package paths of all Blueprints, * for any characters and ? for one (e.g. '/Game/AI/*' or '/Game/*/BP_Enemy*')."
+				},
+				"maxBlueprints": {
+					"type": "integer",
+					"description": "Most Blueprints to export in one call. Defaults to 50, at most 500."
+				},
+				"stream": {
+					"type": "boolean",
+					"description": "Send each export as a partial result as soon as it is done, leaving only the summary for the final result. Defaults to false."
+				}
+			}
+		})"));
+		Server->RegisterTool(MoveTemp(Tool));
+	}
 	
 	// {
 	//   	FUMCP_ToolDefinition Tool;
@@ -98,7 +249,64 @@ void FUMCP_CommonTools::Register(class FUMCP_Server* Server)
 	// }
 }
 
-bool FUMCP_CommonTools::ExportBlueprintToT3D(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent)
+void FUMCP_CommonTools::ExportBlueprintToT3D(TSharedPtr<FJsonObject> arguments, const TSharedRef<FUMCP_ToolCallCompletion>& Completion)
+{
+	auto Fail = [&Completion](FString&& Message)
+	{
+		TArray<FUMCP_CallToolResultContent> Content;
+		FUMCP_CallToolResultContent& ErrorContent = Content.AddDefaulted_GetRef();
+		ErrorContent.type = TEXT("text");
+		ErrorContent.text = MoveTemp(Message);
+		Completion->Complete(false, MoveTemp(Content));
+	};
+
+	FString BlueprintPath = arguments->GetStringField(TEXT("BlueprintPath"));
+	if (BlueprintPath.IsEmpty())
+	{
+		Fail(TEXT("Missing BlueprintPath parameter."));
+		return;
+	}
+
+	bool bStream = false;
+	arguments->TryGetBoolField(TEXT("stream"), bStream);
+	FString KnownVersion;
+	arguments->TryGetStringField(TEXT("knownVersion"), KnownVersion);
+	const TSharedPtr<FUMCP_RequestContext>& RequestContext = Completion->GetContext();
+	bStream = bStream && RequestContext.IsValid() && RequestContext->IsStreaming();
+
+	// Streamed or not, the export is recorded as a version, so a later call can diff against it
+	FUMCP_T3DExportCache::FVersionedExport Export;
+	FString Error;
+	if (!ExportCache->ExportSince(BlueprintPath, KnownVersion, Export, Error))
+	{
+		Fail(MoveTemp(Error));
+		return;
+	}
+
+	// The text comes first, so clients that ignore versions keep reading the export where they did
+	TArray<FUMCP_CallToolResultContent> Content;
+	FUMCP_CallToolResultContent& TextContent = Content.AddDefaulted_GetRef();
+	TextContent.type = TEXT("text");
+	FUMCP_CallToolResultContent& VersionContent = Content.AddDefaulted_GetRef();
+	VersionContent.type = TEXT("text");
+	VersionContent.text = Export.GetInfoJson();
+
+	TSharedPtr<FUMCP_GameThreadScheduler> Scheduler = GameThreadScheduler.Pin();
+	if (!bStream || !Scheduler.IsValid())
+	{
+		TextContent.text = MoveTemp(Export.Text);
+		Completion->Complete(true, MoveTemp(Content));
+		return;
+	}
+
+	// The export itself can't be interrupted, but sending it can wait on the client, so the event stream doesn't end up
+	// holding a second copy of the whole text
+	const int32 ChunkChars = FMath::Max(CVarT3DExportChunkChars.GetValueOnGameThread(), 1024);
+	const int64 MaxPendingBytes = static_cast<int64>(FMath::Max(CVarT3DExportStreamMaxPendingKB.GetValueOnGameThread(), 1)) * 1024;
+	FUMCP_StreamedText::Start(MoveTemp(Export.Text), ChunkChars, MaxPendingBytes, MoveTemp(Content), Scheduler.ToSharedRef(), Completion);
+}
+
+bool FUMCP_CommonTools::ExportBlueprintGraph(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent)
 {
 	auto& Content = OutContent.Add_GetRef(FUMCP_CallToolResultContent());
 	Content.type = TEXT("text");
@@ -110,33 +318,98 @@ bool FUMCP_CommonTools::ExportBlueprintToT3D(TSharedPtr<FJsonObject> arguments,
 		return false;
 	}
 
-	UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
-	if (!Blueprint)
+	TArray<FString> FieldNames;
+	arguments->TryGetStringArrayField(TEXT("fields"), FieldNames);
+	FUMCP_BlueprintGraphExport::EFields Fields = FUMCP_BlueprintGraphExport::EFields::Default;
+	if (!FUMCP_BlueprintGraphExport::ParseFields(FieldNames, Fields, Content.text))
 	{
-		Content.text = FString::Printf(TEXT("Failed to load Blueprint: %s"), *BlueprintPath);
 		return false;
 	}
+	return FUMCP_BlueprintGraphExport::Export(BlueprintPath, Fields, Content.text);
+}
 
-	UExporter* Exporter = UExporter::FindExporter(Blueprint, TEXT("T3D"));
-	if (!Exporter)
+void FUMCP_CommonTools::ExportBlueprintsToT3D(TSharedPtr<FJsonObject> arguments, const TSharedRef<FUMCP_ToolCallCompletion>& Completion)
+{
+	auto Fail = [&Completion](FString&& Message)
 	{
-		Content.text = FString::Printf(TEXT("Failed to find T3D exporter for Blueprint: %s"), *BlueprintPath);
-		return false;
+		TArray<FUMCP_CallToolResultContent> Content;
+		FUMCP_CallToolResultContent& ErrorContent = Content.AddDefaulted_GetRef();
+		ErrorContent.type = TEXT("text");
+		ErrorContent.text = MoveTemp(Message);
+		Completion->Complete(false, MoveTemp(Content));
+	};
+
+	int32 MaxBlueprints = 50;
+	arguments->TryGetNumberField(TEXT("maxBlueprints"), MaxBlueprints);
+	MaxBlueprints = FMath::Clamp(MaxBlueprints, 1, 500);
+	bool bStream = false;
+	arguments->TryGetBoolField(TEXT("stream"), bStream);
+
+	TArray<FString> BlueprintPaths;
+	const TArray<TSharedPtr<FJsonValue>>* PathsArray = nullptr;
+	if (arguments->TryGetArrayField(TEXT("blueprintPaths"), PathsArray))
+	{
+		for (const TSharedPtr<FJsonValue>& PathValue : *PathsArray)
+		{
+			const FString BlueprintPath = PathValue->AsString();
+			if (!FPackageName::IsValidObjectPath(BlueprintPath))
+			{
+				Fail(FString::Printf(TEXT("Invalid Blueprint path: %s"), *BlueprintPath));
+				return;
+			}
+			BlueprintPaths.AddUnique(BlueprintPath);
+		}
 	}
 
-	FStringOutputDevice OutputDevice;
-	const uint32 ExportFlags = PPF_Copy | PPF_ExportsNotFullyQualified;
-	UE_LOG(LogUnrealMCPServer, Log, TEXT("Attempting to export Blueprint '%s' to T3D format using exporter: %s"), *BlueprintPath, *Exporter->GetClass()->GetName());
-	Exporter->ExportText(nullptr, Blueprint, TEXT("T3D"), OutputDevice, GWarn, ExportFlags);
-	if (OutputDevice.IsEmpty())
+	FString PathPattern;
+	if (arguments->TryGetStringField(TEXT("pathPattern"), PathPattern) && !PathPattern.IsEmpty())
 	{
-		Content.text = FString::Printf(TEXT("ExportText did not produce any output for Blueprint: %s. Using exporter: %s."), *BlueprintPath, *Exporter->GetClass()->GetName());
-		UE_LOG(LogUnrealMCPServer, Warning, TEXT("%s"), *Content.text);
-		return false;
+		// Only the folder before the first wildcard needs scanning
+		int32 WildcardIndex = PathPattern.Len();
+		for (const TCHAR Wildcard : { TEXT('*'), TEXT('?') })
+		{
+			int32 Found = INDEX_NONE;
+			if (PathPattern.FindChar(Wildcard, Found))
+			{
+				WildcardIndex = FMath::Min(WildcardIndex, Found);
+			}
+		}
+		FUMCP_BlueprintIndex::FQuery Query;
+		Query.bAllAssets = true;
+		Query.PackagePath = PathPattern.Left(WildcardIndex);
+		int32 LastSlash = INDEX_NONE;
+		Query.PackagePath.FindLastChar(TEXT('/'), LastSlash);
+		Query.PackagePath.LeftInline(FMath::Max(LastSlash, 0));
+		FUMCP_BlueprintIndex::FResults Results;
+		BlueprintIndex->Search(Query, Results);
+		for (const FUMCP_BlueprintIndex::FHit& Hit : Results.Hits)
+		{
+			const FString ObjectPath = Hit.AssetPath.ToString();
+			if (ObjectPath.MatchesWildcard(PathPattern) || Hit.AssetPath.GetLongPackageName().MatchesWildcard(PathPattern))
+			{
+				BlueprintPaths.AddUnique(ObjectPath);
+			}
+		}
 	}
 
-	Content.text = OutputDevice;
-	return true;
+	if (!PathsArray && PathPattern.IsEmpty())
+	{
+		Fail(TEXT("Missing required parameters: blueprintPaths or pathPattern is required."));
+		return;
+	}
+	if (BlueprintPaths.Num() > MaxBlueprints)
+	{
+		Fail(FString::Printf(TEXT("%d Blueprints match, more than maxBlueprints (%d). Narrow the paths or raise the limit."), BlueprintPaths.Num(), MaxBlueprints));
+		return;
+	}
+	TSharedPtr<FUMCP_GameThreadScheduler> Scheduler = GameThreadScheduler.Pin();
+	if (!Scheduler.IsValid())
+	{
+		Fail(TEXT("The server is shutting down."));
+		return;
+	}
+
+	FUMCP_BatchT3DExport::Start(MoveTemp(BlueprintPaths), bStream, ExportCache, Scheduler.ToSharedRef(), Completion);
 }
 
 bool FUMCP_CommonTools::SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent)
@@ -149,6 +422,13 @@ bool FUMCP_CommonTools::SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArr
 	FString SearchTerm = arguments->GetStringField(TEXT("searchTerm"));
 	FString PackagePath = arguments->GetStringField(TEXT("packagePath"));
 	bool bRecursive = arguments->GetBoolField(TEXT("recursive"));
+	int32 Limit = 50;
+	arguments->TryGetNumberField(TEXT("limit"), Limit);
+	Limit = FMath::Clamp(Limit, 1, 500);
+	FString Cursor;
+	arguments->TryGetStringField(TEXT("cursor"), Cursor);
+	int32 MaxDepth = 0;
+	arguments->TryGetNumberField(TEXT("maxDepth"), MaxDepth);
 
 	// Validate required parameters
 	if (SearchType.IsEmpty() || SearchTerm.IsEmpty())
@@ -156,104 +436,205 @@ bool FUMCP_CommonTools::SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArr
 		Content.text = TEXT("Missing required parameters: searchType and searchTerm are required.");
 		return false;
 	}
+	// Any other type would build a query without terms, which matches every Blueprint in scope
+	if (SearchType != TEXT("name") && SearchType != TEXT("parent_class") && SearchType != TEXT("all") && SearchType != TEXT("fuzzy") && SearchType != TEXT("content"))
+	{
+		Content.text = FString::Printf(TEXT("Invalid searchType '%s': expected one of name, parent_class, all, fuzzy or content."), *SearchType);
+		return false;
+	}
 
 	UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Type=%s, Term=%s, Path=%s, Recursive=%s"), 
 		*SearchType, *SearchTerm, *PackagePath, bRecursive ? TEXT("true") : TEXT("false"));
 
-	// Get Asset Registry
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+	// Every search type matches case-insensitively, and a trailing slash doesn't change the scope
+	FString NormalizedPackagePath = PackagePath.ToLower();
+	NormalizedPackagePath.RemoveFromEnd(TEXT("/"));
+	const FString CacheKey = FString::Printf(TEXT("%s\n%s\n%s\n%d\n%d\n%d\n%s"), *SearchType.ToLower(), *SearchTerm.ToLower(),
+		*NormalizedPackagePath, bRecursive ? 1 : 0, Limit, MaxDepth, *Cursor);
+	// Taken before searching, so a change during the search leaves its result stale rather than cached as current
+	const uint64 Generation = BlueprintIndex->GetGeneration();
+	{
+		FScopeLock CacheScopeLock(&SearchCacheLock);
+		if (SearchCacheGeneration != Generation)
+		{
+			SearchCache.Reset();
+			SearchCacheOrder.Reset();
+			SearchCacheGeneration = Generation;
+		}
+		if (const FString* CachedResult = SearchCache.Find(CacheKey))
+		{
+			UE_LOG(LogUnrealMCPServer, Verbose, TEXT("SearchBlueprints: Served from the cache"));
+			Content.text = *CachedResult;
+			return true;
+		}
+	}
 
-	// Prepare search filter
-	FARFilter Filter;
-	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
-	Filter.bRecursiveClasses = true;
-	
-	// Add package path filter if specified
-	if (!PackagePath.IsEmpty())
+	// Query the resident index rather than the asset registry
+	FUMCP_BlueprintIndex::FQuery Query;
+	if (SearchType == TEXT("name") || SearchType == TEXT("all"))
+	{
+		Query.NameTerm = SearchTerm;
+	}
+	if (SearchType == TEXT("parent_class") || SearchType == TEXT("all"))
+	{
+		Query.ParentClassTerm = SearchTerm;
+		Query.MaxDepth = MaxDepth;
+	}
+	if (SearchType == TEXT("fuzzy"))
+	{
+		Query.FuzzyTerm = SearchTerm;
+	}
+	Query.PackagePath = PackagePath;
+	Query.bRecursivePaths = bRecursive;
+	Query.Limit = Limit;
+	Query.Cursor = Cursor;
+	FUMCP_RequestContext* RequestContext = FUMCP_RequestContext::GetCurrent();
+
+	// Content is searched in every Blueprint in scope up front, the index then pages through the ones with hits
+	TSet<FSoftObjectPath> ContentAssets;
+	TMap<FSoftObjectPath, FUMCP_BlueprintContentSearch::FAssetHits> ContentHits;
+	int32 UnindexedAssets = 0;
+	if (SearchType == TEXT("content"))
 	{
-		Filter.PackagePaths.Add(FName(*PackagePath));
-		Filter.bRecursivePaths = bRecursive;
+		FUMCP_BlueprintIndex::FQuery ScopeQuery;
+		ScopeQuery.PackagePath = PackagePath;
+		ScopeQuery.bRecursivePaths = bRecursive;
+		ScopeQuery.bAllAssets = true;
+		FUMCP_BlueprintIndex::FResults ScopeResults;
+		BlueprintIndex->Search(ScopeQuery, ScopeResults);
+		TArray<FSoftObjectPath> AssetPaths;
+		AssetPaths.Reserve(ScopeResults.Hits.Num());
+		for (const FUMCP_BlueprintIndex::FHit& Hit : ScopeResults.Hits)
+		{
+			AssetPaths.Add(Hit.AssetPath);
+		}
+
+		FUMCP_BlueprintContentSearch::FResults ContentResults;
+		FUMCP_BlueprintContentSearch::Search(AssetPaths, SearchTerm, MaxContentMatchesPerBlueprint, RequestContext, ContentResults);
+		if (ContentResults.bCancelled)
+		{
+			UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Cancelled while searching the content of %d Blueprints"), AssetPaths.Num());
+			Content.text = TEXT("Search cancelled.");
+			return false;
+		}
+		UnindexedAssets = ContentResults.UnindexedAssets;
+		for (FUMCP_BlueprintContentSearch::FAssetHits& AssetHits : ContentResults.Assets)
+		{
+			ContentAssets.Add(AssetHits.AssetPath);
+			ContentHits.Add(AssetHits.AssetPath, MoveTemp(AssetHits));
+		}
+		Query.bAllAssets = true;
+		Query.OnlyAssets = &ContentAssets;
 	}
 
-	// Perform asset search
-	TArray<FAssetData> AssetDataList;
-	AssetRegistry.GetAssets(Filter, AssetDataList);
+	FUMCP_BlueprintIndex::FResults Results;
+	if (!BlueprintIndex->Search(Query, Results))
+	{
+		Content.text = TEXT("Invalid cursor.");
+		return false;
+	}
+	const TArray<FUMCP_BlueprintIndex::FHit>& Hits = Results.Hits;
 
-	UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Found %d Blueprint assets before filtering"), AssetDataList.Num());
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Found %d matching Blueprint assets, returning %d"), Results.TotalHits, Hits.Num());
 
 	// Build results JSON
 	TSharedPtr<FJsonObject> ResultsJson = MakeShareable(new FJsonObject);
 	TArray<TSharedPtr<FJsonValue>> ResultsArray;
-	int32 TotalMatches = 0;
 
-	for (const FAssetData& AssetData : AssetDataList)
+	for (int32 HitIndex = 0; HitIndex < Hits.Num(); ++HitIndex)
 	{
-		bool bMatches = false;
+		const FUMCP_BlueprintIndex::FHit& Hit = Hits[HitIndex];
+		if (RequestContext && HitIndex % 256 == 0)
+		{
+			// Nobody is waiting for the result any more
+			if (RequestContext->IsCancelled())
+			{
+				UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Cancelled after %d of %d results"), HitIndex, Hits.Num());
+				Content.text = TEXT("Search cancelled.");
+				return false;
+			}
+			RequestContext->ReportProgress(HitIndex, Hits.Num(), TEXT("Building Blueprint results"));
+		}
+
+		const FString AssetName = Hit.AssetName.ToString();
 		TArray<TSharedPtr<FJsonValue>> MatchesArray;
+		if (Hit.bNameMatch)
+		{
+			// Add match detail
+			TSharedPtr<FJsonObject> MatchJson = MakeShareable(new FJsonObject);
+			MatchJson->SetStringField(TEXT("type"), TEXT("asset_name"));
+			MatchJson->SetStringField(TEXT("location"), TEXT("Blueprint Asset"));
+			MatchJson->SetStringField(TEXT("context"), FString::Printf(TEXT("Blueprint name '%s' contains '%s'"), 
+				*AssetName, *SearchTerm));
+			MatchesArray.Add(MakeShareable(new FJsonValueObject(MatchJson)));
+		}
+		if (Hit.bParentClassMatch)
+		{
+			// Add match detail
+			TSharedPtr<FJsonObject> MatchJson = MakeShareable(new FJsonObject);
+			MatchJson->SetStringField(TEXT("type"), TEXT("parent_class"));
+			MatchJson->SetStringField(TEXT("location"), TEXT("Blueprint Asset"));
+			MatchJson->SetStringField(TEXT("context"), Hit.Depth == 1
+				? FString::Printf(TEXT("Parent class '%s' is '%s'"), *Hit.ParentClass, *SearchTerm)
+				: FString::Printf(TEXT("Derives from '%s' through %d levels"), *SearchTerm, Hit.Depth));
+			MatchJson->SetNumberField(TEXT("depth"), Hit.Depth);
+			MatchesArray.Add(MakeShareable(new FJsonValueObject(MatchJson)));
+		}
 
-		// Apply search type filters
-		if (SearchType == TEXT("name") || SearchType == TEXT("all"))
+		if (Hit.Score > 0)
 		{
-			if (AssetData.AssetName.ToString().Contains(SearchTerm))
+			TSharedPtr<FJsonObject> MatchJson = MakeShareable(new FJsonObject);
+			MatchJson->SetStringField(TEXT("type"), TEXT("fuzzy"));
+			MatchJson->SetStringField(TEXT("location"), TEXT("Blueprint Asset"));
+			MatchJson->SetStringField(TEXT("context"), FString::Printf(TEXT("Blueprint name '%s' resembles '%s'"),
+				*AssetName, *SearchTerm));
+			MatchesArray.Add(MakeShareable(new FJsonValueObject(MatchJson)));
+		}
+		const FUMCP_BlueprintContentSearch::FAssetHits* AssetContentHits = ContentHits.Find(Hit.AssetPath);
+		if (AssetContentHits)
+		{
+			for (const FUMCP_BlueprintContentSearch::FHit& ContentHit : AssetContentHits->Hits)
 			{
-				bMatches = true;
-				
-				// Add match detail
 				TSharedPtr<FJsonObject> MatchJson = MakeShareable(new FJsonObject);
-				MatchJson->SetStringField(TEXT("type"), TEXT("asset_name"));
-				MatchJson->SetStringField(TEXT("location"), TEXT("Blueprint Asset"));
-				MatchJson->SetStringField(TEXT("context"), FString::Printf(TEXT("Blueprint name '%s' contains '%s'"), 
-					*AssetData.AssetName.ToString(), *SearchTerm));
+				MatchJson->SetStringField(TEXT("type"), ContentHit.Type);
+				MatchJson->SetStringField(TEXT("location"), ContentHit.Location);
+				MatchJson->SetStringField(TEXT("context"), FString::Printf(TEXT("%s '%s' contains '%s'"),
+					*ContentHit.Field, *ContentHit.Text, *SearchTerm));
 				MatchesArray.Add(MakeShareable(new FJsonValueObject(MatchJson)));
 			}
 		}
 
-		if (SearchType == TEXT("parent_class") || SearchType == TEXT("all"))
+		TSharedPtr<FJsonObject> BlueprintResult = MakeShareable(new FJsonObject);
+		BlueprintResult->SetStringField(TEXT("assetPath"), Hit.AssetPath.ToString());
+		BlueprintResult->SetStringField(TEXT("assetName"), AssetName);
+		BlueprintResult->SetStringField(TEXT("packagePath"), Hit.PackagePath.ToString());
+		BlueprintResult->SetStringField(TEXT("parentClass"), Hit.ParentClass);
+		BlueprintResult->SetArrayField(TEXT("matches"), MatchesArray);
+		if (Hit.Score > 0)
 		{
-			// Get parent class information from asset tags
-			FString ParentClassPath;
-			if (AssetData.GetTagValue(TEXT("ParentClass"), ParentClassPath))
-			{
-				if (ParentClassPath.Contains(SearchTerm))
-				{
-					bMatches = true;
-					
-					// Add match detail
-					TSharedPtr<FJsonObject> MatchJson = MakeShareable(new FJsonObject);
-					MatchJson->SetStringField(TEXT("type"), TEXT("parent_class"));
-					MatchJson->SetStringField(TEXT("location"), TEXT("Blueprint Asset"));
-					MatchJson->SetStringField(TEXT("context"), FString::Printf(TEXT("Parent class '%s' contains '%s'"), 
-						*ParentClassPath, *SearchTerm));
-					MatchesArray.Add(MakeShareable(new FJsonValueObject(MatchJson)));
-				}
-			}
+			// Out of FUMCP_FuzzyMatch::MaxScore
+			BlueprintResult->SetNumberField(TEXT("score"), Hit.Score);
 		}
-
-		// If this Blueprint matches, add it to results
-		if (bMatches)
+		if (AssetContentHits && AssetContentHits->TotalHits > AssetContentHits->Hits.Num())
 		{
-			TotalMatches++;
-			
-			TSharedPtr<FJsonObject> BlueprintResult = MakeShareable(new FJsonObject);
-			BlueprintResult->SetStringField(TEXT("assetPath"), AssetData.GetSoftObjectPath().ToString());
-			BlueprintResult->SetStringField(TEXT("assetName"), AssetData.AssetName.ToString());
-			BlueprintResult->SetStringField(TEXT("packagePath"), AssetData.PackagePath.ToString());
-			
-			// Get parent class for display
-			FString ParentClassPath;
-			AssetData.GetTagValue(TEXT("ParentClass"), ParentClassPath);
-			BlueprintResult->SetStringField(TEXT("parentClass"), ParentClassPath);
-			
-			BlueprintResult->SetArrayField(TEXT("matches"), MatchesArray);
-			
-			ResultsArray.Add(MakeShareable(new FJsonValueObject(BlueprintResult)));
+			BlueprintResult->SetNumberField(TEXT("totalMatches"), AssetContentHits->TotalHits);
 		}
+
+		ResultsArray.Add(MakeShareable(new FJsonValueObject(BlueprintResult)));
 	}
 
 	// Build final result JSON
 	ResultsJson->SetArrayField(TEXT("results"), ResultsArray);
-	ResultsJson->SetNumberField(TEXT("totalResults"), TotalMatches);
+	ResultsJson->SetNumberField(TEXT("totalResults"), Results.TotalHits);
+	if (!Results.NextCursor.IsEmpty())
+	{
+		ResultsJson->SetStringField(TEXT("nextCursor"), Results.NextCursor);
+	}
+	if (UnindexedAssets > 0)
+	{
+		// Their content could not be searched without loading them
+		ResultsJson->SetNumberField(TEXT("unindexedBlueprints"), UnindexedAssets);
+	}
 	
 	TSharedPtr<FJsonObject> SearchCriteriaJson = MakeShareable(new FJsonObject);
 	SearchCriteriaJson->SetStringField(TEXT("searchType"), SearchType);
@@ -263,6 +644,11 @@ bool FUMCP_CommonTools::SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArr
 		SearchCriteriaJson->SetStringField(TEXT("packagePath"), PackagePath);
 	}
 	SearchCriteriaJson->SetBoolField(TEXT("recursive"), bRecursive);
+	SearchCriteriaJson->SetNumberField(TEXT("limit"), Limit);
+	if (MaxDepth > 0)
+	{
+		SearchCriteriaJson->SetNumberField(TEXT("maxDepth"), MaxDepth);
+	}
 	ResultsJson->SetObjectField(TEXT("searchCriteria"), SearchCriteriaJson);
 
 	// Convert to JSON string
@@ -271,8 +657,222 @@ bool FUMCP_CommonTools::SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArr
 	FJsonSerializer::Serialize(ResultsJson.ToSharedRef(), Writer);
 
 	Content.text = ResultJsonString;
+
+	{
+		FScopeLock CacheScopeLock(&SearchCacheLock);
+		// Assets changed while searching, this result may already be stale
+		if (SearchCacheGeneration == Generation && BlueprintIndex->GetGeneration() == Generation && !SearchCache.Contains(CacheKey))
+		{
+			if (SearchCacheOrder.Num() >= MaxCachedSearches)
+			{
+				SearchCache.Remove(SearchCacheOrder[0]);
+				SearchCacheOrder.RemoveAt(0);
+			}
+			SearchCache.Add(CacheKey, ResultJsonString);
+			SearchCacheOrder.Add(CacheKey);
+		}
+	}
 	
-	UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Completed search, found %d matches"), TotalMatches);
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("SearchBlueprints: Completed search, returned %d of %d matches"), Hits.Num(), Results.TotalHits);
 	
 	return true;
 }
+
+bool FUMCP_CommonTools::QueryAssetReferences(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent)
+{
+	using namespace UE::AssetRegistry;
+
+	auto& Content = OutContent.Add_GetRef(FUMCP_CallToolResultContent());
+	Content.type = TEXT("text");
+
+	const TArray<TSharedPtr<FJsonValue>>* AssetsArray = nullptr;
+	if (!arguments->TryGetArrayField(TEXT("assets"), AssetsArray) || AssetsArray->IsEmpty())
+	{
+		Content.text = TEXT("Missing required parameter: assets.");
+		return false;
+	}
+	FString Direction = TEXT("dependencies");
+	arguments->TryGetStringField(TEXT("direction"), Direction);
+	const bool bReferencers = Direction == TEXT("referencers");
+	if (!bReferencers && Direction != TEXT("dependencies"))
+	{
+		Content.text = FString::Printf(TEXT("Unknown direction '%s', expected 'dependencies' or 'referencers'."), *Direction);
+		return false;
+	}
+	int32 MaxDepth = 1;
+	arguments->TryGetNumberField(TEXT("maxDepth"), MaxDepth);
+	MaxDepth = FMath::Clamp(MaxDepth, 1, 16);
+	int32 MaxNodes = 1000;
+	arguments->TryGetNumberField(TEXT("maxNodes"), MaxNodes);
+	MaxNodes = FMath::Clamp(MaxNodes, 1, 20000);
+	bool bHardOnly = false;
+	arguments->TryGetBoolField(TEXT("hardOnly"), bHardOnly);
+
+	EDependencyCategory Categories = EDependencyCategory::Package;
+	const TArray<TSharedPtr<FJsonValue>>* CategoriesArray = nullptr;
+	if (arguments->TryGetArrayField(TEXT("categories"), CategoriesArray) && !CategoriesArray->IsEmpty())
+	{
+		Categories = EDependencyCategory::None;
+		for (const TSharedPtr<FJsonValue>& CategoryValue : *CategoriesArray)
+		{
+			const FString Category = CategoryValue->AsString();
+			if (Category == TEXT("package"))
+			{
+				Categories |= EDependencyCategory::Package;
+			}
+			else if (Category == TEXT("manage"))
+			{
+				Categories |= EDependencyCategory::Manage;
+			}
+			else if (Category == TEXT("searchable_name"))
+			{
+				Categories |= EDependencyCategory::SearchableName;
+			}
+			else
+			{
+				Content.text = FString::Printf(TEXT("Unknown category '%s', expected 'package', 'manage' or 'searchable_name'."), *Category);
+				return false;
+			}
+		}
+	}
+	const FDependencyQuery DependencyQuery(bHardOnly ? EDependencyQuery::Hard : EDependencyQuery::NoRequirements);
+
+	// Nodes get dense ids in the order they are found, which index the visited bits and the edge list
+	TArray<FAssetIdentifier> Nodes;
+	TArray<int32> NodeDepths;
+	TMap<FAssetIdentifier, int32> NodeIds;
+	TBitArray<> Visited;
+	bool bTruncated = false;
+	auto FindOrAddNode = [&](const FAssetIdentifier& AssetId, int32 Depth)
+	{
+		if (const int32* ExistingId = NodeIds.Find(AssetId))
+		{
+			return *ExistingId;
+		}
+		if (Nodes.Num() >= MaxNodes)
+		{
+			bTruncated = true;
+			return int32(INDEX_NONE);
+		}
+		const int32 Id = Nodes.Add(AssetId);
+		NodeDepths.Add(Depth);
+		NodeIds.Add(AssetId, Id);
+		Visited.Add(false);
+		return Id;
+	};
+
+	TArray<int32> Frontier;
+	for (const TSharedPtr<FJsonValue>& AssetValue : *AssetsArray)
+	{
+		FString PackageName = AssetValue->AsString();
+		if (FPackageName::IsValidObjectPath(PackageName))
+		{
+			PackageName = FPackageName::ObjectPathToPackageName(PackageName);
+		}
+		if (!FPackageName::IsValidLongPackageName(PackageName))
+		{
+			Content.text = FString::Printf(TEXT("Invalid asset path: %s"), *AssetValue->AsString());
+			return false;
+		}
+		const int32 Id = FindOrAddNode(FAssetIdentifier(FName(*PackageName)), 0);
+		if (Id != INDEX_NONE && !Visited[Id])
+		{
+			Visited[Id] = true;
+			Frontier.Add(Id);
+		}
+	}
+
+	// Edges as (from, to, kind) with from always the referencer, whichever way the search goes
+	struct FEdge
+	{
+		int32 From;
+		int32 To;
+		const TCHAR* Kind;
+	};
+	TArray<FEdge> Edges;
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	FUMCP_RequestContext* RequestContext = FUMCP_RequestContext::GetCurrent();
+	TArray<FAssetDependency> Links;
+	TArray<int32> NextFrontier;
+	// One level at a time, so every node comes with its shortest distance from the roots
+	for (int32 Depth = 1; Depth <= MaxDepth && !Frontier.IsEmpty(); ++Depth)
+	{
+		if (RequestContext && RequestContext->IsCancelled())
+		{
+			Content.text = TEXT("Query cancelled.");
+			return false;
+		}
+		NextFrontier.Reset();
+		for (int32 NodeId : Frontier)
+		{
+			Links.Reset();
+			if (bReferencers)
+			{
+				AssetRegistry.GetReferencers(Nodes[NodeId], Links, Categories, DependencyQuery);
+			}
+			else
+			{
+				AssetRegistry.GetDependencies(Nodes[NodeId], Links, Categories, DependencyQuery);
+			}
+			for (const FAssetDependency& Link : Links)
+			{
+				const int32 LinkId = FindOrAddNode(Link.AssetId, Depth);
+				if (LinkId == INDEX_NONE)
+				{
+					continue;
+				}
+				const TCHAR* Kind = Link.Category == EDependencyCategory::Manage ? TEXT("manage")
+					: Link.Category == EDependencyCategory::SearchableName ? TEXT("name")
+					: EnumHasAnyFlags(Link.Properties, EDependencyProperty::Hard) ? TEXT("hard") : TEXT("soft");
+				Edges.Add(FEdge{ bReferencers ? LinkId : NodeId, bReferencers ? NodeId : LinkId, Kind });
+				if (!Visited[LinkId])
+				{
+					Visited[LinkId] = true;
+					NextFrontier.Add(LinkId);
+				}
+			}
+		}
+		Swap(Frontier, NextFrontier);
+		if (RequestContext)
+		{
+			RequestContext->ReportProgress(Depth, MaxDepth, FString::Printf(TEXT("Found %d assets"), Nodes.Num()));
+		}
+	}
+
+	TArray<TSharedPtr<FJsonValue>> NodesArray;
+	NodesArray.Reserve(Nodes.Num());
+	for (int32 Id = 0; Id < Nodes.Num(); ++Id)
+	{
+		TArray<TSharedPtr<FJsonValue>> Node;
+		Node.Add(MakeShared<FJsonValueString>(Nodes[Id].ToString()));
+		Node.Add(MakeShared<FJsonValueNumber>(NodeDepths[Id]));
+		NodesArray.Add(MakeShared<FJsonValueArray>(Node));
+	}
+	TArray<TSharedPtr<FJsonValue>> EdgesArray;
+	EdgesArray.Reserve(Edges.Num());
+	for (const FEdge& Edge : Edges)
+	{
+		TArray<TSharedPtr<FJsonValue>> EdgeJson;
+		EdgeJson.Add(MakeShared<FJsonValueNumber>(Edge.From));
+		EdgeJson.Add(MakeShared<FJsonValueNumber>(Edge.To));
+		EdgeJson.Add(MakeShared<FJsonValueString>(Edge.Kind));
+		EdgesArray.Add(MakeShared<FJsonValueArray>(EdgeJson));
+	}
+
+	TSharedPtr<FJsonObject> ResultJson = MakeShareable(new FJsonObject);
+	ResultJson->SetStringField(TEXT("direction"), bReferencers ? TEXT("referencers") : TEXT("dependencies"));
+	// [path, depth], where depth 0 is a starting asset
+	ResultJson->SetArrayField(TEXT("nodes"), NodesArray);
+	// [referencer, referenced, kind], indices into nodes; kind is hard, soft, manage or name
+	ResultJson->SetArrayField(TEXT("edges"), EdgesArray);
+	ResultJson->SetBoolField(TEXT("truncated"), bTruncated);
+
+	FString ResultJsonString;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ResultJsonString);
+	FJsonSerializer::Serialize(ResultJson.ToSharedRef(), Writer);
+	Content.text = ResultJsonString;
+
+	UE_LOG(LogUnrealMCPServer, Log, TEXT("QueryAssetReferences: %d assets and %d references from %d starting assets%s"),
+		Nodes.Num(), Edges.Num(), AssetsArray->Num(), bTruncated ? TEXT(", truncated") : TEXT(""));
+	return true;
+}
@@ -0,0 +1,223 @@
+#include "UMCP_EventStream.h"
+#include "UMCP_JsonUtf8.h"
+#include "UnrealMCPServerModule.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HttpServerResponse.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarEventStreamFlushIntervalMs(
+		TEXT("UMCP.EventStream.FlushIntervalMs"),
+		250,
+		TEXT("How long a pending event stream poll gathers events after the first one arrives before it is answered."));
+
+	TAutoConsoleVariable<float> CVarEventStreamPollTimeoutSeconds(
+		TEXT("UMCP.EventStream.PollTimeoutSeconds"),
+		10.0f,
+		TEXT("Longest an event stream poll is held with nothing to send, keeps clients clear of their request timeouts."));
+
+	TAutoConsoleVariable<int32> CVarEventStreamRetryMs(
+		TEXT("UMCP.EventStream.RetryMs"),
+		100,
+		TEXT("SSE retry interval sent to clients, which is how soon they come back for more events."));
+
+	// Streams nobody has polled for this long are dropped
+	constexpr double EventStreamRetainSeconds = 60.0;
+
+	void AppendAnsi(TArray<uint8>& Out, const ANSICHAR* Text)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+	}
+
+	void AppendEventHeader(TArray<uint8>& Out, uint32 StreamId, uint32 Sequence)
+	{
+		ANSICHAR Header[48];
+		FCStringAnsi::Snprintf(Header, UE_ARRAY_COUNT(Header), "id: %u-%u\n", StreamId, Sequence);
+		AppendAnsi(Out, Header);
+	}
+}
+
+FUMCP_EventStream::FUMCP_EventStream(uint32 InStreamId)
+	: StreamId(InStreamId)
+	, LastPollTime(FPlatformTime::Seconds())
+{
+	// Prime the client with an event id straight away, so it can resume even if nothing else arrives before the first poll ends
+	FEvent& Primer = Events.AddDefaulted_GetRef();
+	Primer.Sequence = NextSequence++;
+	AppendEventHeader(Primer.Data, StreamId, Primer.Sequence);
+	AppendAnsi(Primer.Data, "data: \n\n");
+	PendingBytes = Primer.Data.Num();
+}
+
+void FUMCP_EventStream::PushMessage(const TArray<uint8>& JsonMessage)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bClosed)
+	{
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("Dropped a message pushed to closed event stream %u."), StreamId);
+		return;
+	}
+
+	FEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Sequence = NextSequence++;
+	Event.Data.Reserve(JsonMessage.Num() + 32);
+	AppendEventHeader(Event.Data, StreamId, Event.Sequence);
+	// Messages are condensed JSON, so they always fit on a single data line
+	AppendAnsi(Event.Data, "data: ");
+	Event.Data.Append(JsonMessage);
+	AppendAnsi(Event.Data, "\n\n");
+	PendingBytes += Event.Data.Num();
+
+	if (Poller.IsSet())
+	{
+		Poller->Deadline = FMath::Min(Poller->Deadline, FPlatformTime::Seconds() + CVarEventStreamFlushIntervalMs.GetValueOnAnyThread() / 1000.0);
+	}
+}
+
+int32 FUMCP_EventStream::PushResponse(const FUMCP_JsonRpcResponse& Response)
+{
+	TArray<uint8> JsonMessage;
+	JsonMessage.Reserve(Response.EstimateJsonUtf8Size());
+	if (!Response.ToJsonUtf8(JsonMessage))
+	{
+		return 0;
+	}
+	PushMessage(JsonMessage);
+	return JsonMessage.Num();
+}
+
+void FUMCP_EventStream::PushNotification(const FString& Method, const TSharedPtr<FJsonObject>& Params)
+{
+	TArray<uint8> JsonMessage;
+	FUMCP_JsonUtf8Writer Writer(JsonMessage);
+	Writer.WriteRaw("{\"jsonrpc\":\"2.0\",\"method\":");
+	Writer.WriteString(Method);
+	if (Params.IsValid())
+	{
+		Writer.WriteRaw(",\"params\":");
+		Writer.WriteObject(*Params);
+	}
+	Writer.WriteRaw("}");
+	PushMessage(JsonMessage);
+}
+
+void FUMCP_EventStream::Close()
+{
+	FScopeLock ScopeLock(&Lock);
+	bClosed = true;
+}
+
+bool FUMCP_EventStream::IsClosed() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return bClosed;
+}
+
+int64 FUMCP_EventStream::GetPendingBytes() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return PendingBytes;
+}
+
+void FUMCP_EventStream::AddPoller(uint32 AfterSequence, const FHttpResultCallback& OnComplete)
+{
+	FScopeLock ScopeLock(&Lock);
+	const double Now = FPlatformTime::Seconds();
+	LastPollTime = Now;
+
+	// Everything the client has seen no longer needs to be kept for a replay
+	Events.RemoveAll([this, AfterSequence](const FEvent& Event)
+	{
+		if (Event.Sequence > AfterSequence)
+		{
+			return false;
+		}
+		PendingBytes -= Event.Data.Num();
+		return true;
+	});
+
+	if (Poller.IsSet())
+	{
+		StalePollers.Add(MoveTemp(Poller->OnComplete));
+	}
+	const bool bHasEvents = Events.Num() > 0;
+	Poller = FPoller{ AfterSequence, Now + (bHasEvents ? CVarEventStreamFlushIntervalMs.GetValueOnAnyThread() / 1000.0 : CVarEventStreamPollTimeoutSeconds.GetValueOnAnyThread()), OnComplete };
+}
+
+bool FUMCP_EventStream::Tick(double Now)
+{
+	TArray<FHttpResultCallback> Stale;
+	FHttpResultCallback DueCallback;
+	TArray<uint8> Body;
+	bool bFinished = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Stale = MoveTemp(StalePollers);
+
+		if (Poller.IsSet() && (bClosed || Now >= Poller->Deadline))
+		{
+			if (!bClosed)
+			{
+				ANSICHAR Retry[32];
+				FCStringAnsi::Snprintf(Retry, UE_ARRAY_COUNT(Retry), "retry: %d\n\n", CVarEventStreamRetryMs.GetValueOnAnyThread());
+				AppendAnsi(Body, Retry);
+			}
+			for (const FEvent& Event : Events)
+			{
+				if (Event.Sequence > Poller->AfterSequence)
+				{
+					Body.Append(Event.Data);
+				}
+			}
+			if (Body.IsEmpty())
+			{
+				AppendAnsi(Body, ": keep-alive\n\n");
+			}
+			DueCallback = MoveTemp(Poller->OnComplete);
+			Poller.Reset();
+			LastPollTime = Now;
+		}
+
+		bFinished = !Poller.IsSet() && Now - LastPollTime > EventStreamRetainSeconds;
+	}
+
+	for (const FHttpResultCallback& OnComplete : Stale)
+	{
+		TArray<uint8> KeepAlive;
+		AppendAnsi(KeepAlive, ": superseded\n\n");
+		CompletePoller(OnComplete, MoveTemp(KeepAlive));
+	}
+	if (DueCallback)
+	{
+		CompletePoller(DueCallback, MoveTemp(Body));
+	}
+	return bFinished;
+}
+
+void FUMCP_EventStream::CompletePoller(const FHttpResultCallback& OnComplete, TArray<uint8>&& Body)
+{
+	check(IsInGameThread());
+	TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(MoveTemp(Body), TEXT("text/event-stream"));
+	if (!Response.IsValid())
+	{
+		UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to create an event stream response."));
+		return;
+	}
+	Response->Code = EHttpServerResponseCodes::Ok;
+	Response->Headers.Add(TEXT("Cache-Control"), { TEXT("no-cache") });
+	OnComplete(MoveTemp(Response));
+}
+
+bool FUMCP_EventStream::ParseEventId(const FString& EventId, uint32& OutStreamId, uint32& OutSequence)
+{
+	FString StreamPart;
+	FString SequencePart;
+	if (!EventId.TrimStartAndEnd().Split(TEXT("-"), &StreamPart, &SequencePart) || !StreamPart.IsNumeric() || !SequencePart.IsNumeric())
+	{
+		return false;
+	}
+	OutStreamId = static_cast<uint32>(FCString::Strtoui64(*StreamPart, nullptr, 10));
+	OutSequence = static_cast<uint32>(FCString::Strtoui64(*SequencePart, nullptr, 10));
+	return true;
+}
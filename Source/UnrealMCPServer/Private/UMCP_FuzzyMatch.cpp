@@ -0,0 +1,108 @@
+#include "UMCP_FuzzyMatch.h"
+
+#include "String/Find.h"
+
+namespace
+{
+	// Patterns are cut to this before the edit distance is taken, it is quadratic
+	constexpr int32 MaxEditDistancePatternLength = 64;
+
+	// Word starts in names like BP_PlayerController or Weapon2Base
+	bool IsWordStart(FStringView Text, int32 Index)
+	{
+		if (Index == 0)
+		{
+			return true;
+		}
+		const TCHAR Previous = Text[Index - 1];
+		const TCHAR Current = Text[Index];
+		return Previous == TEXT('_') || Previous == TEXT(' ') || Previous == TEXT('-')
+			|| (FChar::IsLower(Previous) && FChar::IsUpper(Current))
+			|| (!FChar::IsDigit(Previous) && FChar::IsDigit(Current));
+	}
+
+	// Bonus points for a subsequence match, or INDEX_NONE if Pattern isn't a subsequence of Candidate
+	int32 ScoreSubsequence(FStringView Pattern, FStringView Candidate)
+	{
+		int32 Bonus = 0;
+		int32 PatternIndex = 0;
+		bool bPreviousMatched = false;
+		for (int32 Index = 0; Index < Candidate.Len() && PatternIndex < Pattern.Len(); ++Index)
+		{
+			const bool bMatched = FChar::ToLower(Candidate[Index]) == FChar::ToLower(Pattern[PatternIndex]);
+			if (bMatched)
+			{
+				Bonus += (IsWordStart(Candidate, Index) ? 10 : 0) + (bPreviousMatched ? 5 : 0);
+				++PatternIndex;
+			}
+			bPreviousMatched = bMatched;
+		}
+		return PatternIndex == Pattern.Len() ? Bonus : INDEX_NONE;
+	}
+
+	// Fewest edits turning Pattern into some substring of Candidate
+	int32 GetSubstringEditDistance(FStringView Pattern, FStringView Candidate)
+	{
+		TArray<int32, TInlineAllocator<MaxEditDistancePatternLength + 1>> Column;
+		Column.SetNumUninitialized(Pattern.Len() + 1);
+		for (int32 Row = 0; Row <= Pattern.Len(); ++Row)
+		{
+			Column[Row] = Row;
+		}
+		int32 Best = Pattern.Len();
+		for (TCHAR CandidateChar : Candidate)
+		{
+			// A match may start anywhere in the candidate
+			int32 Diagonal = 0;
+			for (int32 Row = 1; Row <= Pattern.Len(); ++Row)
+			{
+				const int32 Above = Column[Row];
+				const int32 Cost = FChar::ToLower(Pattern[Row - 1]) == FChar::ToLower(CandidateChar) ? 0 : 1;
+				Column[Row] = FMath::Min3(Above + 1, Column[Row - 1] + 1, Diagonal + Cost);
+				Diagonal = Above;
+			}
+			Best = FMath::Min(Best, Column[Pattern.Len()]);
+		}
+		return Best;
+	}
+}
+
+int32 FUMCP_FuzzyMatch::Score(FStringView Pattern, FStringView Candidate)
+{
+	if (Pattern.IsEmpty() || Candidate.IsEmpty())
+	{
+		return 0;
+	}
+	if (Candidate.Equals(Pattern, ESearchCase::IgnoreCase))
+	{
+		return MaxScore;
+	}
+
+	// Within each tier, shorter candidates are closer to what was typed
+	const int32 ExtraChars = FMath::Max(Candidate.Len() - Pattern.Len(), 0);
+	if (Candidate.StartsWith(Pattern, ESearchCase::IgnoreCase))
+	{
+		return 900 - FMath::Min(ExtraChars, 99);
+	}
+	const int32 Position = UE::String::FindFirst(Candidate, Pattern, ESearchCase::IgnoreCase);
+	if (Position != INDEX_NONE)
+	{
+		return 800 - FMath::Min(Position, 50) - FMath::Min(ExtraChars, 49);
+	}
+
+	const int32 Bonus = ScoreSubsequence(Pattern, Candidate);
+	if (Bonus != INDEX_NONE)
+	{
+		// Every character at a word start and following the previous one scores the full 150
+		return 500 + Bonus * 150 / (15 * Pattern.Len()) - FMath::Min(ExtraChars, 50);
+	}
+
+	const FStringView ClampedPattern = Pattern.Left(MaxEditDistancePatternLength);
+	const int32 MaxDistance = FMath::Max(1, ClampedPattern.Len() / 4);
+	const int32 Distance = GetSubstringEditDistance(ClampedPattern, Candidate);
+	if (Distance <= MaxDistance)
+	{
+		return 400 - 100 * Distance / (MaxDistance + 1);
+	}
+	return 0;
+}
@@ -0,0 +1,809 @@
+#include "UMCP_JsonUtf8.h"
+
+namespace
+{
+	// Deeper documents are rejected rather than risking the stack on hostile input
+	constexpr int32 MaxJsonDepth = 512;
+
+	bool IsJsonWhitespace(uint8 Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
+	}
+
+	void AppendCodepointUtf8(TArray<uint8>& Out, uint32 Codepoint)
+	{
+		if (Codepoint < 0x80)
+		{
+			Out.Add(static_cast<uint8>(Codepoint));
+		}
+		else if (Codepoint < 0x800)
+		{
+			Out.Add(static_cast<uint8>(0xC0 | (Codepoint >> 6)));
+			Out.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+		}
+		else if (Codepoint < 0x10000)
+		{
+			Out.Add(static_cast<uint8>(0xE0 | (Codepoint >> 12)));
+			Out.Add(static_cast<uint8>(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add(static_cast<uint8>(0xF0 | (Codepoint >> 18)));
+			Out.Add(static_cast<uint8>(0x80 | ((Codepoint >> 12) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | ((Codepoint >> 6) & 0x3F)));
+			Out.Add(static_cast<uint8>(0x80 | (Codepoint & 0x3F)));
+		}
+	}
+
+	FString Utf8ToString(const uint8* Bytes, int32 Length)
+	{
+		FUTF8ToTCHAR Convert(reinterpret_cast<const ANSICHAR*>(Bytes), Length);
+		return FString(Convert.Length(), Convert.Get());
+	}
+}
+
+TArrayView<const uint8> FUMCP_JsonUtf8View::GetBytes() const
+{
+	if (!Buffer.IsValid())
+	{
+		return TArrayView<const uint8>();
+	}
+	return TArrayView<const uint8>(Buffer->GetData() + Offset, Length);
+}
+
+TSharedPtr<FJsonValue> FUMCP_JsonUtf8View::Parse() const
+{
+	FUMCP_JsonUtf8Reader Reader(GetBytes());
+	TSharedPtr<FJsonValue> Value = Reader.ReadValue();
+	if (!Value.IsValid() || !Reader.IsAtEnd())
+	{
+		return nullptr;
+	}
+	return Value;
+}
+
+TSharedPtr<FJsonObject> FUMCP_JsonUtf8View::ParseObject() const
+{
+	TSharedPtr<FJsonValue> Value = Parse();
+	if (!Value.IsValid() || Value->Type != EJson::Object)
+	{
+		return nullptr;
+	}
+	return Value->AsObject();
+}
+
+bool FUMCP_JsonUtf8View::TryGetStringField(const FString& FieldName, FString& OutValue) const
+{
+	FUMCP_JsonUtf8Reader Reader(GetBytes());
+	if (!Reader.BeginObject())
+	{
+		return false;
+	}
+	FString Key;
+	while (Reader.NextMember(Key))
+	{
+		if (Key == FieldName && Reader.Peek() == '"')
+		{
+			return Reader.ReadString(OutValue);
+		}
+		if (!Reader.SkipValue())
+		{
+			return false;
+		}
+	}
+	return false;
+}
+
+void FUMCP_JsonUtf8Reader::SkipWhitespace()
+{
+	while (Pos < Data.Num() && IsJsonWhitespace(Data[Pos]))
+	{
+		++Pos;
+	}
+}
+
+bool FUMCP_JsonUtf8Reader::Fail()
+{
+	bError = true;
+	return false;
+}
+
+uint8 FUMCP_JsonUtf8Reader::Peek()
+{
+	SkipWhitespace();
+	return Pos < Data.Num() ? Data[Pos] : 0;
+}
+
+bool FUMCP_JsonUtf8Reader::TryConsume(uint8 Char)
+{
+	if (Peek() != Char)
+	{
+		return false;
+	}
+	++Pos;
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::IsAtEnd()
+{
+	SkipWhitespace();
+	return Pos >= Data.Num();
+}
+
+bool FUMCP_JsonUtf8Reader::BeginObject()
+{
+	if (bError || !TryConsume('{'))
+	{
+		return Fail();
+	}
+	bFirstItem = true;
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::NextMember(FString& OutKey)
+{
+	if (bError)
+	{
+		return false;
+	}
+	if (TryConsume('}'))
+	{
+		bFirstItem = false;
+		return false;
+	}
+	if (!bFirstItem && !TryConsume(','))
+	{
+		return Fail();
+	}
+	bFirstItem = false;
+	if (Peek() != '"' || !ReadString(OutKey) || !TryConsume(':'))
+	{
+		return Fail();
+	}
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::BeginArray()
+{
+	if (bError || !TryConsume('['))
+	{
+		return Fail();
+	}
+	bFirstItem = true;
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::NextElement()
+{
+	if (bError)
+	{
+		return false;
+	}
+	if (TryConsume(']'))
+	{
+		bFirstItem = false;
+		return false;
+	}
+	if (!bFirstItem && !TryConsume(','))
+	{
+		return Fail();
+	}
+	bFirstItem = false;
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::ScanLiteral(const ANSICHAR* Literal)
+{
+	const int32 LiteralLen = FCStringAnsi::Strlen(Literal);
+	if (Pos + LiteralLen > Data.Num() || FMemory::Memcmp(Data.GetData() + Pos, Literal, LiteralLen) != 0)
+	{
+		return Fail();
+	}
+	Pos += LiteralLen;
+	return true;
+}
+
+// Steps over a string starting at the opening quote. When OutUtf8 is set the unescaped UTF-8 bytes are appended to it.
+bool FUMCP_JsonUtf8Reader::ScanString(TArray<uint8>* OutUtf8)
+{
+	if (Peek() != '"')
+	{
+		return Fail();
+	}
+	++Pos;
+
+	int32 RunStart = Pos;
+	while (Pos < Data.Num())
+	{
+		const uint8 Char = Data[Pos];
+		if (Char == '"')
+		{
+			if (OutUtf8)
+			{
+				OutUtf8->Append(Data.GetData() + RunStart, Pos - RunStart);
+			}
+			++Pos;
+			return true;
+		}
+		if (Char < 0x20)
+		{
+			return Fail();
+		}
+		if (Char != '\\')
+		{
+			++Pos;
+			continue;
+		}
+
+		if (OutUtf8)
+		{
+			OutUtf8->Append(Data.GetData() + RunStart, Pos - RunStart);
+		}
+		if (Pos + 1 >= Data.Num())
+		{
+			return Fail();
+		}
+		const uint8 Escape = Data[Pos + 1];
+		Pos += 2;
+		uint8 Unescaped = 0;
+		switch (Escape)
+		{
+		case '"': Unescaped = '"'; break;
+		case '\\': Unescaped = '\\'; break;
+		case '/': Unescaped = '/'; break;
+		case 'b': Unescaped = '\b'; break;
+		case 'f': Unescaped = '\f'; break;
+		case 'n': Unescaped = '\n'; break;
+		case 'r': Unescaped = '\r'; break;
+		case 't': Unescaped = '\t'; break;
+		case 'u':
+			{
+				auto ReadHex4 = [this](uint32& OutValue) -> bool
+				{
+					if (Pos + 4 > Data.Num())
+					{
+						return false;
+					}
+					OutValue = 0;
+					for (int32 Index = 0; Index < 4; ++Index)
+					{
+						const uint8 Hex = Data[Pos + Index];
+						OutValue <<= 4;
+						if (Hex >= '0' && Hex <= '9') { OutValue |= Hex - '0'; }
+						else if (Hex >= 'a' && Hex <= 'f') { OutValue |= Hex - 'a' + 10; }
+						else if (Hex >= 'A' && Hex <= 'F') { OutValue |= Hex - 'A' + 10; }
+						else { return false; }
+					}
+					Pos += 4;
+					return true;
+				};
+
+				uint32 Codepoint = 0;
+				if (!ReadHex4(Codepoint))
+				{
+					return Fail();
+				}
+				// Combine UTF-16 surrogate pairs, lone surrogates become U+FFFD
+				if (Codepoint >= 0xD800 && Codepoint <= 0xDBFF)
+				{
+					uint32 Low = 0;
+					if (Pos + 1 < Data.Num() && Data[Pos] == '\\' && Data[Pos + 1] == 'u')
+					{
+						Pos += 2;
+						if (!ReadHex4(Low))
+						{
+							return Fail();
+						}
+					}
+					Codepoint = (Low >= 0xDC00 && Low <= 0xDFFF) ? 0x10000 + ((Codepoint - 0xD800) << 10) + (Low - 0xDC00) : 0xFFFD;
+				}
+				else if (Codepoint >= 0xDC00 && Codepoint <= 0xDFFF)
+				{
+					Codepoint = 0xFFFD;
+				}
+				if (OutUtf8)
+				{
+					AppendCodepointUtf8(*OutUtf8, Codepoint);
+				}
+				RunStart = Pos;
+				continue;
+			}
+		default:
+			return Fail();
+		}
+		if (OutUtf8)
+		{
+			OutUtf8->Add(Unescaped);
+		}
+		RunStart = Pos;
+	}
+	return Fail();
+}
+
+bool FUMCP_JsonUtf8Reader::ScanNumber(double* OutNumber)
+{
+	SkipWhitespace();
+	const int32 Start = Pos;
+	auto IsDigit = [this]() { return Pos < Data.Num() && Data[Pos] >= '0' && Data[Pos] <= '9'; };
+
+	if (Pos < Data.Num() && Data[Pos] == '-')
+	{
+		++Pos;
+	}
+	if (!IsDigit())
+	{
+		return Fail();
+	}
+	if (Data[Pos] == '0')
+	{
+		++Pos;
+	}
+	else
+	{
+		while (IsDigit()) { ++Pos; }
+	}
+	if (Pos < Data.Num() && Data[Pos] == '.')
+	{
+		++Pos;
+		if (!IsDigit())
+		{
+			return Fail();
+		}
+		while (IsDigit()) { ++Pos; }
+	}
+	if (Pos < Data.Num() && (Data[Pos] == 'e' || Data[Pos] == 'E'))
+	{
+		++Pos;
+		if (Pos < Data.Num() && (Data[Pos] == '+' || Data[Pos] == '-'))
+		{
+			++Pos;
+		}
+		if (!IsDigit())
+		{
+			return Fail();
+		}
+		while (IsDigit()) { ++Pos; }
+	}
+
+	if (OutNumber)
+	{
+		// Atod wants a terminated string, numbers are short so copy them out
+		TArray<ANSICHAR, TInlineAllocator<64>> NumberText;
+		NumberText.Append(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Start), Pos - Start);
+		NumberText.Add('\0');
+		*OutNumber = FCStringAnsi::Atod(NumberText.GetData());
+	}
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::ReadString(FString& OutString)
+{
+	SkipWhitespace();
+	const int32 Start = Pos;
+	if (!ScanString(nullptr))
+	{
+		return false;
+	}
+
+	// Fast path: strings without escapes convert straight from the buffer
+	const uint8* Raw = Data.GetData() + Start + 1;
+	const int32 RawLength = Pos - Start - 2;
+	if (!TArrayView<const uint8>(Raw, RawLength).Contains('\\'))
+	{
+		OutString = Utf8ToString(Raw, RawLength);
+		return true;
+	}
+
+	const int32 End = Pos;
+	Pos = Start;
+	TArray<uint8> Unescaped;
+	Unescaped.Reserve(RawLength);
+	ScanString(&Unescaped);
+	check(Pos == End);
+	OutString = Utf8ToString(Unescaped.GetData(), Unescaped.Num());
+	return true;
+}
+
+bool FUMCP_JsonUtf8Reader::SkipValue()
+{
+	if (bError)
+	{
+		return false;
+	}
+	switch (Peek())
+	{
+	case '{':
+		{
+			if (++Depth > MaxJsonDepth)
+			{
+				return Fail();
+			}
+			++Pos;
+			bool bFirst = true;
+			while (!TryConsume('}'))
+			{
+				if ((!bFirst && !TryConsume(',')) || !ScanString(nullptr) || !TryConsume(':') || !SkipValue())
+				{
+					return Fail();
+				}
+				bFirst = false;
+			}
+			--Depth;
+			return true;
+		}
+	case '[':
+		{
+			if (++Depth > MaxJsonDepth)
+			{
+				return Fail();
+			}
+			++Pos;
+			bool bFirst = true;
+			while (!TryConsume(']'))
+			{
+				if ((!bFirst && !TryConsume(',')) || !SkipValue())
+				{
+					return Fail();
+				}
+				bFirst = false;
+			}
+			--Depth;
+			return true;
+		}
+	case '"':
+		return ScanString(nullptr);
+	case 't':
+		return ScanLiteral("true");
+	case 'f':
+		return ScanLiteral("false");
+	case 'n':
+		return ScanLiteral("null");
+	default:
+		return ScanNumber(nullptr);
+	}
+}
+
+TSharedPtr<FJsonValue> FUMCP_JsonUtf8Reader::ReadValue()
+{
+	if (bError)
+	{
+		return nullptr;
+	}
+	switch (Peek())
+	{
+	case '{':
+		{
+			if (++Depth > MaxJsonDepth)
+			{
+				Fail();
+				return nullptr;
+			}
+			++Pos;
+			TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+			bool bFirst = true;
+			while (!TryConsume('}'))
+			{
+				FString Key;
+				if ((!bFirst && !TryConsume(',')) || !ReadString(Key) || !TryConsume(':'))
+				{
+					Fail();
+					return nullptr;
+				}
+				TSharedPtr<FJsonValue> Value = ReadValue();
+				if (!Value.IsValid())
+				{
+					return nullptr;
+				}
+				Object->SetField(Key, MoveTemp(Value));
+				bFirst = false;
+			}
+			--Depth;
+			return MakeShared<FJsonValueObject>(MoveTemp(Object));
+		}
+	case '[':
+		{
+			if (++Depth > MaxJsonDepth)
+			{
+				Fail();
+				return nullptr;
+			}
+			++Pos;
+			TArray<TSharedPtr<FJsonValue>> Elements;
+			bool bFirst = true;
+			while (!TryConsume(']'))
+			{
+				if (!bFirst && !TryConsume(','))
+				{
+					Fail();
+					return nullptr;
+				}
+				TSharedPtr<FJsonValue> Value = ReadValue();
+				if (!Value.IsValid())
+				{
+					return nullptr;
+				}
+				Elements.Add(MoveTemp(Value));
+				bFirst = false;
+			}
+			--Depth;
+			return MakeShared<FJsonValueArray>(MoveTemp(Elements));
+		}
+	case '"':
+		{
+			FString String;
+			if (!ReadString(String))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueString>(MoveTemp(String));
+		}
+	case 't':
+		{
+			if (!ScanLiteral("true"))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueBoolean>(true);
+		}
+	case 'f':
+		{
+			if (!ScanLiteral("false"))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueBoolean>(false);
+		}
+	case 'n':
+		{
+			if (!ScanLiteral("null"))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueNull>();
+		}
+	default:
+		{
+			double Number = 0.0;
+			if (!ScanNumber(&Number))
+			{
+				return nullptr;
+			}
+			return MakeShared<FJsonValueNumber>(Number);
+		}
+	}
+}
+
+bool UMCP_SplitJsonUtf8Body(const TSharedPtr<const TArray<uint8>>& Body, TArray<FUMCP_JsonUtf8View>& OutEntries, bool& bOutIsBatch)
+{
+	bOutIsBatch = false;
+	if (!Body.IsValid())
+	{
+		return false;
+	}
+
+	// Tolerate a UTF-8 byte order mark
+	const bool bHasBom = Body->Num() >= 3 && (*Body)[0] == 0xEF && (*Body)[1] == 0xBB && (*Body)[2] == 0xBF;
+	const int32 BaseOffset = bHasBom ? 3 : 0;
+	FUMCP_JsonUtf8Reader Reader(TArrayView<const uint8>(Body->GetData() + BaseOffset, Body->Num() - BaseOffset));
+
+	if (Reader.Peek() != '[')
+	{
+		const int32 Start = Reader.GetPosition();
+		if (!Reader.SkipValue() || !Reader.IsAtEnd())
+		{
+			return false;
+		}
+		OutEntries.Emplace(Body, BaseOffset + Start, Reader.GetPosition() - Start);
+		return true;
+	}
+
+	bOutIsBatch = true;
+	Reader.BeginArray();
+	while (Reader.NextElement())
+	{
+		Reader.Peek();
+		const int32 Start = Reader.GetPosition();
+		if (!Reader.SkipValue())
+		{
+			return false;
+		}
+		OutEntries.Emplace(Body, BaseOffset + Start, Reader.GetPosition() - Start);
+	}
+	return !Reader.HasError() && Reader.IsAtEnd();
+}
+
+void FUMCP_JsonUtf8Writer::WriteRaw(const ANSICHAR* Json)
+{
+	Out.Append(reinterpret_cast<const uint8*>(Json), FCStringAnsi::Strlen(Json));
+}
+
+void FUMCP_JsonUtf8Writer::WriteString(FStringView String)
+{
+	static const ANSICHAR HexDigits[] = "0123456789abcdef";
+
+	Out.Add('"');
+	const TCHAR* Chars = String.GetData();
+	const int32 Len = String.Len();
+	for (int32 Index = 0; Index < Len; ++Index)
+	{
+		uint32 Codepoint = static_cast<uint32>(Chars[Index]);
+		if (Codepoint < 0x80)
+		{
+			switch (Codepoint)
+			{
+			case '"': Out.Add('\\'); Out.Add('"'); break;
+			case '\\': Out.Add('\\'); Out.Add('\\'); break;
+			case '\n': Out.Add('\\'); Out.Add('n'); break;
+			case '\r': Out.Add('\\'); Out.Add('r'); break;
+			case '\t': Out.Add('\\'); Out.Add('t'); break;
+			case '\b': Out.Add('\\'); Out.Add('b'); break;
+			case '\f': Out.Add('\\'); Out.Add('f'); break;
+			default:
+				if (Codepoint < 0x20)
+				{
+					const uint8 Escape[] = { '\\', 'u', '0', '0', static_cast<uint8>(HexDigits[Codepoint >> 4]), static_cast<uint8>(HexDigits[Codepoint & 0xF]) };
+					Out.Append(Escape, UE_ARRAY_COUNT(Escape));
+				}
+				else
+				{
+					Out.Add(static_cast<uint8>(Codepoint));
+				}
+				break;
+			}
+			continue;
+		}
+
+		// TCHAR is UTF-16 on some platforms, join surrogate pairs before encoding
+		if (Codepoint >= 0xD800 && Codepoint <= 0xDBFF)
+		{
+			const uint32 Low = Index + 1 < Len ? static_cast<uint32>(Chars[Index + 1]) : 0;
+			if (Low >= 0xDC00 && Low <= 0xDFFF)
+			{
+				Codepoint = 0x10000 + ((Codepoint - 0xD800) << 10) + (Low - 0xDC00);
+				++Index;
+			}
+			else
+			{
+				Codepoint = 0xFFFD;
+			}
+		}
+		else if ((Codepoint >= 0xDC00 && Codepoint <= 0xDFFF) || Codepoint > 0x10FFFF)
+		{
+			Codepoint = 0xFFFD;
+		}
+		AppendCodepointUtf8(Out, Codepoint);
+	}
+	Out.Add('"');
+}
+
+void FUMCP_JsonUtf8Writer::WriteNumber(double Number)
+{
+	if (!FMath::IsFinite(Number))
+	{
+		WriteNull();
+		return;
+	}
+
+	ANSICHAR Buffer[32];
+	// Whole numbers print without a fraction so ids and counts round-trip exactly
+	if (Number == FMath::FloorToDouble(Number) && FMath::Abs(Number) < 9007199254740992.0)
+	{
+		FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%lld", static_cast<long long>(Number));
+	}
+	else
+	{
+		FCStringAnsi::Snprintf(Buffer, UE_ARRAY_COUNT(Buffer), "%.17g", Number);
+	}
+	WriteRaw(Buffer);
+}
+
+void FUMCP_JsonUtf8Writer::WriteValue(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value.IsValid())
+	{
+		WriteNull();
+		return;
+	}
+
+	switch (Value->Type)
+	{
+	case EJson::String:
+		WriteString(Value->AsString());
+		break;
+	case EJson::Number:
+		WriteNumber(Value->AsNumber());
+		break;
+	case EJson::Boolean:
+		WriteBool(Value->AsBool());
+		break;
+	case EJson::Array:
+		{
+			Out.Add('[');
+			bool bFirst = true;
+			for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+			{
+				if (!bFirst)
+				{
+					Out.Add(',');
+				}
+				WriteValue(Element);
+				bFirst = false;
+			}
+			Out.Add(']');
+			break;
+		}
+	case EJson::Object:
+		{
+			const TSharedPtr<FJsonObject>& Object = Value->AsObject();
+			if (Object.IsValid())
+			{
+				WriteObject(*Object);
+			}
+			else
+			{
+				WriteNull();
+			}
+			break;
+		}
+	case EJson::Null:
+	case EJson::None:
+	default:
+		WriteNull();
+		break;
+	}
+}
+
+void FUMCP_JsonUtf8Writer::WriteObject(const FJsonObject& Object)
+{
+	Out.Add('{');
+	bool bFirst = true;
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Member : Object.Values)
+	{
+		if (!bFirst)
+		{
+			Out.Add(',');
+		}
+		WriteString(Member.Key);
+		Out.Add(':');
+		WriteValue(Member.Value);
+		bFirst = false;
+	}
+	Out.Add('}');
+}
+
+int64 FUMCP_JsonUtf8Writer::EstimateSize(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value.IsValid())
+	{
+		return 4;
+	}
+	switch (Value->Type)
+	{
+	case EJson::String:
+		return Value->AsString().Len() + 2;
+	case EJson::Array:
+		{
+			int64 Size = 2;
+			for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+			{
+				Size += EstimateSize(Element) + 1;
+			}
+			return Size;
+		}
+	case EJson::Object:
+		return Value->AsObject().IsValid() ? EstimateSize(*Value->AsObject()) : 4;
+	default:
+		return 8;
+	}
+}
+
+int64 FUMCP_JsonUtf8Writer::EstimateSize(const FJsonObject& Object)
+{
+	int64 Size = 2;
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Member : Object.Values)
+	{
+		Size += Member.Key.Len() + 4 + EstimateSize(Member.Value);
+	}
+	return Size;
+}
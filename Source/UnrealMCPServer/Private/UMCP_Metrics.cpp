@@ -0,0 +1,171 @@
+#include "UMCP_Metrics.h"
+#include "UnrealMCPServerModule.h"
+
+#include "ProfilingDebugging/CountersTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("JSON-RPC Calls"), STAT_UMCP_Calls, STATGROUP_UnrealMCPServer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("JSON-RPC Errors"), STAT_UMCP_Errors, STATGROUP_UnrealMCPServer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bytes Received"), STAT_UMCP_BytesReceived, STATGROUP_UnrealMCPServer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bytes Sent"), STAT_UMCP_BytesSent, STATGROUP_UnrealMCPServer);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Last Call (ms)"), STAT_UMCP_LastCallMs, STATGROUP_UnrealMCPServer);
+
+TRACE_DECLARE_INT_COUNTER(UMCP_Calls, TEXT("UnrealMCPServer/Calls"));
+TRACE_DECLARE_INT_COUNTER(UMCP_Errors, TEXT("UnrealMCPServer/Errors"));
+TRACE_DECLARE_FLOAT_COUNTER(UMCP_LastCallMs, TEXT("UnrealMCPServer/LastCallMs"));
+
+void FUMCP_LatencyHistogram::Add(double Seconds)
+{
+	Seconds = FMath::Max(Seconds, 0.0);
+	const double Micros = Seconds * 1000000.0;
+	const int32 Bucket = Micros <= 1.0 ? 0 : FMath::Clamp(FMath::FloorToInt32(FMath::Log2(Micros) * BucketsPerDoubling), 0, NumBuckets - 1);
+	++Buckets[Bucket];
+	++Count;
+	TotalSeconds += Seconds;
+	MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+}
+
+double FUMCP_LatencyHistogram::GetPercentileMs(double Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count)));
+	uint64 Seen = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Seen += Buckets[Bucket];
+		if (Seen >= Rank)
+		{
+			const double UpperMicros = FMath::Pow(2.0, static_cast<double>(Bucket + 1) / BucketsPerDoubling);
+			return FMath::Min(UpperMicros / 1000.0, GetMaxMs());
+		}
+	}
+	return GetMaxMs();
+}
+
+double FUMCP_LatencyHistogram::GetMeanMs() const
+{
+	return Count > 0 ? TotalSeconds * 1000.0 / Count : 0.0;
+}
+
+TSharedRef<FJsonObject> FUMCP_LatencyHistogram::ToJson() const
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("count"), static_cast<double>(Count));
+	Json->SetNumberField(TEXT("meanMs"), GetMeanMs());
+	Json->SetNumberField(TEXT("p50Ms"), GetPercentileMs(50.0));
+	Json->SetNumberField(TEXT("p95Ms"), GetPercentileMs(95.0));
+	Json->SetNumberField(TEXT("p99Ms"), GetPercentileMs(99.0));
+	Json->SetNumberField(TEXT("maxMs"), GetMaxMs());
+	return Json;
+}
+
+FUMCP_Metrics::FUMCP_Metrics()
+	: StartTime(FPlatformTime::Seconds())
+{
+}
+
+void FUMCP_Metrics::RecordHttpRequest(int32 BodyBytes, double ParseSeconds)
+{
+	INC_DWORD_STAT_BY(STAT_UMCP_BytesReceived, BodyBytes);
+
+	FScopeLock ScopeLock(&Lock);
+	++HttpRequests;
+	HttpRequestBytes += BodyBytes;
+	Parse.Add(ParseSeconds);
+}
+
+void FUMCP_Metrics::RecordHttpResponse(int32 PayloadBytes, double SerializeSeconds)
+{
+	INC_DWORD_STAT_BY(STAT_UMCP_BytesSent, PayloadBytes);
+
+	FScopeLock ScopeLock(&Lock);
+	++HttpResponses;
+	HttpResponseBytes += PayloadBytes;
+	Serialize.Add(SerializeSeconds);
+}
+
+void FUMCP_Metrics::RecordMethodCall(const FString& Method, int32 RequestBytes, const FCallTiming& Timing, bool bError, bool bCancelled)
+{
+	const double TotalSeconds = Timing.QueueWaitSeconds + Timing.ExecuteSeconds;
+	INC_DWORD_STAT(STAT_UMCP_Calls);
+	SET_FLOAT_STAT(STAT_UMCP_LastCallMs, TotalSeconds * 1000.0);
+	TRACE_COUNTER_INCREMENT(UMCP_Calls);
+	TRACE_COUNTER_SET(UMCP_LastCallMs, TotalSeconds * 1000.0);
+	if (bError)
+	{
+		INC_DWORD_STAT(STAT_UMCP_Errors);
+		TRACE_COUNTER_INCREMENT(UMCP_Errors);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	FMethodMetrics& Metrics = Methods.FindOrAdd(Method);
+	++Metrics.Calls;
+	Metrics.Errors += bError ? 1 : 0;
+	Metrics.Cancelled += bCancelled ? 1 : 0;
+	Metrics.RequestBytes += RequestBytes;
+	Metrics.QueueWait.Add(Timing.QueueWaitSeconds);
+	Metrics.Execute.Add(Timing.ExecuteSeconds);
+	Metrics.Total.Add(TotalSeconds);
+}
+
+void FUMCP_Metrics::RecordMethodResponseBytes(const FString& Method, int32 ResponseBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+	Methods.FindOrAdd(Method).ResponseBytes += ResponseBytes;
+}
+
+void FUMCP_Metrics::RecordToolCall(const FString& ToolName, double Seconds, bool bError)
+{
+	FScopeLock ScopeLock(&Lock);
+	FToolMetrics& Metrics = ToolCalls.FindOrAdd(ToolName);
+	++Metrics.Calls;
+	Metrics.Errors += bError ? 1 : 0;
+	Metrics.Duration.Add(Seconds);
+}
+
+TSharedRef<FJsonObject> FUMCP_Metrics::ToJson() const
+{
+	FScopeLock ScopeLock(&Lock);
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("uptimeSeconds"), FPlatformTime::Seconds() - StartTime);
+
+	TSharedRef<FJsonObject> HttpJson = MakeShared<FJsonObject>();
+	HttpJson->SetNumberField(TEXT("requests"), static_cast<double>(HttpRequests));
+	HttpJson->SetNumberField(TEXT("requestBytes"), static_cast<double>(HttpRequestBytes));
+	HttpJson->SetNumberField(TEXT("responses"), static_cast<double>(HttpResponses));
+	HttpJson->SetNumberField(TEXT("responseBytes"), static_cast<double>(HttpResponseBytes));
+	HttpJson->SetObjectField(TEXT("parse"), Parse.ToJson());
+	HttpJson->SetObjectField(TEXT("serialize"), Serialize.ToJson());
+	Json->SetObjectField(TEXT("http"), HttpJson);
+
+	TSharedRef<FJsonObject> MethodsJson = MakeShared<FJsonObject>();
+	for (const TPair<FString, FMethodMetrics>& Method : Methods)
+	{
+		TSharedRef<FJsonObject> MethodJson = MakeShared<FJsonObject>();
+		MethodJson->SetNumberField(TEXT("calls"), static_cast<double>(Method.Value.Calls));
+		MethodJson->SetNumberField(TEXT("errors"), static_cast<double>(Method.Value.Errors));
+		MethodJson->SetNumberField(TEXT("cancelled"), static_cast<double>(Method.Value.Cancelled));
+		MethodJson->SetNumberField(TEXT("requestBytes"), static_cast<double>(Method.Value.RequestBytes));
+		MethodJson->SetNumberField(TEXT("responseBytes"), static_cast<double>(Method.Value.ResponseBytes));
+		MethodJson->SetObjectField(TEXT("queueWait"), Method.Value.QueueWait.ToJson());
+		MethodJson->SetObjectField(TEXT("execute"), Method.Value.Execute.ToJson());
+		MethodJson->SetObjectField(TEXT("total"), Method.Value.Total.ToJson());
+		MethodsJson->SetObjectField(Method.Key, MethodJson);
+	}
+	Json->SetObjectField(TEXT("methods"), MethodsJson);
+
+	TSharedRef<FJsonObject> ToolsJson = MakeShared<FJsonObject>();
+	for (const TPair<FString, FToolMetrics>& Tool : ToolCalls)
+	{
+		TSharedRef<FJsonObject> ToolJson = MakeShared<FJsonObject>();
+		ToolJson->SetNumberField(TEXT("calls"), static_cast<double>(Tool.Value.Calls));
+		ToolJson->SetNumberField(TEXT("errors"), static_cast<double>(Tool.Value.Errors));
+		ToolJson->SetObjectField(TEXT("duration"), Tool.Value.Duration.ToJson());
+		ToolsJson->SetObjectField(Tool.Key, ToolJson);
+	}
+	Json->SetObjectField(TEXT("tools"), ToolsJson);
+	return Json;
+}
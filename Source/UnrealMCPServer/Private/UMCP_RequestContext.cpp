@@ -0,0 +1,102 @@
+#include "UMCP_RequestContext.h"
+#include "UMCP_EventStream.h"
+
+namespace
+{
+	thread_local FUMCP_RequestContext* GCurrentRequestContext = nullptr;
+
+	// Progress faster than this is of no use to a client and only bloats the stream
+	constexpr double MinProgressIntervalSeconds = 0.1;
+}
+
+const FString FUMCP_RequestContext::PartialResultNotification = TEXT("notifications/unrealmcp/partial_result");
+
+FUMCP_RequestContext::FUMCP_RequestContext(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FUMCP_EventStream> InEventStream, const FString& InSessionKey)
+	: RequestId(Request.id)
+	, SessionKey(InSessionKey)
+	, CancellationToken(MakeShared<FUMCP_CancellationToken>())
+	, EventStream(MoveTemp(InEventStream))
+{
+	const TSharedPtr<FJsonObject>* Meta = nullptr;
+	TSharedPtr<FJsonObject> Params = Request.GetParams();
+	if (Params.IsValid() && Params->TryGetObjectField(TEXT("_meta"), Meta))
+	{
+		ProgressToken = (*Meta)->TryGetField(TEXT("progressToken"));
+	}
+}
+
+FUMCP_RequestContext* FUMCP_RequestContext::GetCurrent()
+{
+	return GCurrentRequestContext;
+}
+
+void FUMCP_RequestContext::ReportProgress(double Progress, double Total, const FString& Message)
+{
+	if (!EventStream.IsValid() || !ProgressToken.IsValid() || IsCancelled())
+	{
+		return;
+	}
+	const double Now = FPlatformTime::Seconds();
+	const bool bIsLast = Total > 0.0 && Progress >= Total;
+	if (!bIsLast && Now - LastProgressTime < MinProgressIntervalSeconds)
+	{
+		return;
+	}
+	LastProgressTime = Now;
+
+	TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+	Params->SetField(TEXT("progressToken"), ProgressToken);
+	Params->SetNumberField(TEXT("progress"), Progress);
+	if (Total > 0.0)
+	{
+		Params->SetNumberField(TEXT("total"), Total);
+	}
+	if (!Message.IsEmpty())
+	{
+		Params->SetStringField(TEXT("message"), Message);
+	}
+	EventStream->PushNotification(TEXT("notifications/progress"), Params);
+}
+
+int64 FUMCP_RequestContext::GetPendingStreamBytes() const
+{
+	return EventStream.IsValid() ? EventStream->GetPendingBytes() : 0;
+}
+
+void FUMCP_RequestContext::SendPartialContent(const TArray<FUMCP_CallToolResultContent>& Content)
+{
+	if (!EventStream.IsValid() || Content.IsEmpty() || IsCancelled())
+	{
+		return;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> ContentValues;
+	for (const FUMCP_CallToolResultContent& Item : Content)
+	{
+		TSharedPtr<FJsonObject> ItemObject = MakeShared<FJsonObject>();
+		if (UMCP_ToJsonObject(Item, ItemObject))
+		{
+			ContentValues.Add(MakeShared<FJsonValueObject>(ItemObject));
+		}
+	}
+
+	TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+	Params->SetField(TEXT("requestId"), RequestId.GetJsonValue());
+	if (ProgressToken.IsValid())
+	{
+		Params->SetField(TEXT("progressToken"), ProgressToken);
+	}
+	Params->SetArrayField(TEXT("content"), ContentValues);
+	EventStream->PushNotification(PartialResultNotification, Params);
+}
+
+FUMCP_RequestContextScope::FUMCP_RequestContextScope(FUMCP_RequestContext& Context)
+	: PreviousContext(GCurrentRequestContext)
+{
+	GCurrentRequestContext = &Context;
+}
+
+FUMCP_RequestContextScope::~FUMCP_RequestContextScope()
+{
+	GCurrentRequestContext = PreviousContext;
+}
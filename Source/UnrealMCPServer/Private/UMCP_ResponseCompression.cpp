@@ -0,0 +1,86 @@
+#include "UMCP_ResponseCompression.h"
+
+#include "Misc/Compression.h"
+
+EUMCP_ContentEncoding FUMCP_ResponseCompression::Negotiate(const FString& AcceptEncoding)
+{
+	// -1 for codings the header doesn't name, which then take the q-value of * if there is one
+	float GzipQuality = -1.0f;
+	float DeflateQuality = -1.0f;
+	float AnyQuality = 0.0f;
+
+	TArray<FString> Codings;
+	AcceptEncoding.ParseIntoArray(Codings, TEXT(","));
+	for (const FString& Coding : Codings)
+	{
+		FString Name = Coding;
+		float Quality = 1.0f;
+		FString Parameters;
+		if (Coding.Split(TEXT(";"), &Name, &Parameters))
+		{
+			Parameters.TrimStartAndEndInline();
+			if (Parameters.StartsWith(TEXT("q=")))
+			{
+				Quality = FCString::Atof(*Parameters + 2);
+			}
+		}
+		Name.TrimStartAndEndInline();
+
+		if (Name.Equals(TEXT("gzip"), ESearchCase::IgnoreCase) || Name.Equals(TEXT("x-gzip"), ESearchCase::IgnoreCase))
+		{
+			GzipQuality = Quality;
+		}
+		else if (Name.Equals(TEXT("deflate"), ESearchCase::IgnoreCase))
+		{
+			DeflateQuality = Quality;
+		}
+		else if (Name == TEXT("*"))
+		{
+			AnyQuality = Quality;
+		}
+	}
+
+	GzipQuality = GzipQuality < 0.0f ? AnyQuality : GzipQuality;
+	DeflateQuality = DeflateQuality < 0.0f ? AnyQuality : DeflateQuality;
+	if (GzipQuality > 0.0f && GzipQuality >= DeflateQuality)
+	{
+		return EUMCP_ContentEncoding::Gzip;
+	}
+	return DeflateQuality > 0.0f ? EUMCP_ContentEncoding::Deflate : EUMCP_ContentEncoding::Identity;
+}
+
+const TCHAR* FUMCP_ResponseCompression::GetHeaderValue(EUMCP_ContentEncoding Encoding)
+{
+	switch (Encoding)
+	{
+	case EUMCP_ContentEncoding::Gzip:
+		return TEXT("gzip");
+	case EUMCP_ContentEncoding::Deflate:
+		return TEXT("deflate");
+	default:
+		return TEXT("identity");
+	}
+}
+
+bool FUMCP_ResponseCompression::Compress(EUMCP_ContentEncoding Encoding, TArray<uint8>& Payload)
+{
+	if (Encoding == EUMCP_ContentEncoding::Identity || Payload.IsEmpty())
+	{
+		return false;
+	}
+
+	// HTTP's deflate is the zlib format, not a raw deflate stream
+	const FName FormatName = Encoding == EUMCP_ContentEncoding::Gzip ? NAME_Gzip : NAME_Zlib;
+	int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Payload.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	// Latency matters more than the last few percent of size
+	if (!FCompression::CompressMemory(FormatName, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num(), COMPRESS_BiasSpeed)
+		|| CompressedSize >= Payload.Num())
+	{
+		return false;
+	}
+	Compressed.SetNum(CompressedSize);
+	Payload = MoveTemp(Compressed);
+	return true;
+}
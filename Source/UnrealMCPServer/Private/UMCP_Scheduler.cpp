@@ -0,0 +1,204 @@
+#include "UMCP_Scheduler.h"
+#include "UnrealMCPServerModule.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Queue Depth"), STAT_UMCP_GameThreadQueueDepth, STATGROUP_UnrealMCPServer);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game Thread Queue Max Wait (ms)"), STAT_UMCP_GameThreadQueueMaxWaitMs, STATGROUP_UnrealMCPServer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Items Run"), STAT_UMCP_GameThreadItemsRun, STATGROUP_UnrealMCPServer);
+DECLARE_CYCLE_STAT(TEXT("Drain Game Thread Queue"), STAT_UMCP_DrainGameThreadQueue, STATGROUP_UnrealMCPServer);
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarGameThreadBudgetMs(
+		TEXT("UMCP.GameThreadBudgetMs"),
+		4.0f,
+		TEXT("Milliseconds per frame the MCP server may spend running queued game thread work. At least one item runs every frame."));
+}
+
+FUMCP_GameThreadScheduler::~FUMCP_GameThreadScheduler()
+{
+	Stop();
+}
+
+void FUMCP_GameThreadScheduler::Start()
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		bStopped = false;
+	}
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FUMCP_GameThreadScheduler::Tick));
+	}
+}
+
+void FUMCP_GameThreadScheduler::Stop()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	TArray<FWorkItem> Dropped;
+	{
+		FScopeLock ScopeLock(&Lock);
+		bStopped = true;
+		if (QueueDepth > 0)
+		{
+			UE_LOG(LogUnrealMCPServer, Warning, TEXT("Dropping %d queued game thread requests."), QueueDepth);
+		}
+		Dropped.Reserve(QueueDepth);
+		for (FPriorityQueue& Queue : Queues)
+		{
+			for (FSessionQueue& Session : Queue.Sessions)
+			{
+				for (int32 Index = Session.Head; Index < Session.Items.Num(); ++Index)
+				{
+					Dropped.Add(MoveTemp(Session.Items[Index]));
+				}
+			}
+			Queue = FPriorityQueue();
+		}
+		QueueDepth = 0;
+	}
+
+	// Outside the lock, the callbacks are free to answer however they like
+	for (FWorkItem& Item : Dropped)
+	{
+		if (Item.OnDropped)
+		{
+			Item.OnDropped();
+		}
+	}
+}
+
+void FUMCP_GameThreadScheduler::Enqueue(const FString& SessionKey, EUMCP_RequestPriority Priority, TUniqueFunction<void()>&& Work, TUniqueFunction<void()>&& OnDropped)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!bStopped)
+		{
+			FPriorityQueue& Queue = Queues[static_cast<int32>(Priority)];
+			FSessionQueue* Session = Queue.Sessions.FindByPredicate([&SessionKey](const FSessionQueue& Candidate) { return Candidate.SessionKey == SessionKey; });
+			if (!Session)
+			{
+				Session = &Queue.Sessions.AddDefaulted_GetRef();
+				Session->SessionKey = SessionKey;
+			}
+			Session->Items.Add(FWorkItem{ MoveTemp(Work), MoveTemp(OnDropped), FPlatformTime::Seconds() });
+			++QueueDepth;
+			return;
+		}
+	}
+
+	// Queued from a thread that raced Stop, nothing will drain it any more
+	if (OnDropped)
+	{
+		OnDropped();
+	}
+}
+
+bool FUMCP_GameThreadScheduler::Dequeue(FWorkItem& OutItem)
+{
+	FScopeLock ScopeLock(&Lock);
+	for (FPriorityQueue& Queue : Queues)
+	{
+		if (Queue.Sessions.IsEmpty())
+		{
+			continue;
+		}
+
+		// Take one item from the next session in turn
+		Queue.NextSession %= Queue.Sessions.Num();
+		FSessionQueue& Session = Queue.Sessions[Queue.NextSession];
+		OutItem = MoveTemp(Session.Items[Session.Head++]);
+		--QueueDepth;
+		if (Session.Head >= Session.Items.Num())
+		{
+			Queue.Sessions.RemoveAt(Queue.NextSession);
+		}
+		else
+		{
+			// Compact now and then so a session that never runs dry doesn't grow its array forever
+			if (Session.Head >= 64 && Session.Head * 2 >= Session.Items.Num())
+			{
+				Session.Items.RemoveAt(0, Session.Head);
+				Session.Head = 0;
+			}
+			++Queue.NextSession;
+		}
+		return true;
+	}
+	return false;
+}
+
+bool FUMCP_GameThreadScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UMCP_DrainGameThreadQueue);
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = FMath::Max(0.0f, CVarGameThreadBudgetMs.GetValueOnGameThread()) / 1000.0;
+	double MaxWaitMs = 0.0;
+	int32 ItemsRun = 0;
+	// Work queued while draining waits for the next frame, so work that queues itself again runs once per frame
+	int32 MaxItems = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		MaxItems = QueueDepth;
+	}
+
+	FWorkItem Item;
+	// Always make progress, even when a single item is over budget on its own
+	while (ItemsRun < MaxItems && (ItemsRun == 0 || FPlatformTime::Seconds() - StartTime < BudgetSeconds) && Dequeue(Item))
+	{
+		const double WaitMs = (FPlatformTime::Seconds() - Item.EnqueueTime) * 1000.0;
+		MaxWaitMs = FMath::Max(MaxWaitMs, WaitMs);
+		{
+			FScopeLock ScopeLock(&Lock);
+			AverageWaitMs = AverageWaitMs * 0.9 + WaitMs * 0.1;
+		}
+		Item.Work();
+		Item.Work.Reset();
+		++ItemsRun;
+	}
+
+	int32 RemainingDepth = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (ItemsRun > 0)
+		{
+			LastMaxWaitMs = MaxWaitMs;
+		}
+		RemainingDepth = QueueDepth;
+	}
+	if (ItemsRun > 0 && RemainingDepth > 0)
+	{
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Ran %d game thread requests in %.2f ms, %d still queued."), ItemsRun, (FPlatformTime::Seconds() - StartTime) * 1000.0, RemainingDepth);
+	}
+
+	SET_DWORD_STAT(STAT_UMCP_GameThreadQueueDepth, RemainingDepth);
+	SET_FLOAT_STAT(STAT_UMCP_GameThreadQueueMaxWaitMs, MaxWaitMs);
+	SET_DWORD_STAT(STAT_UMCP_GameThreadItemsRun, ItemsRun);
+	return true;
+}
+
+int32 FUMCP_GameThreadScheduler::GetQueueDepth() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return QueueDepth;
+}
+
+double FUMCP_GameThreadScheduler::GetLastMaxWaitMs() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return LastMaxWaitMs;
+}
+
+double FUMCP_GameThreadScheduler::GetAverageWaitMs() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return AverageWaitMs;
+}
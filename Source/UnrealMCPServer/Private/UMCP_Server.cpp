@@ -2,6 +2,10 @@
 #include "UMCP_Types.h"
 #include "UMCP_CommonTools.h"
 #include "UMCP_CommonResources.h"
+#include "UMCP_EventStream.h"
+#include "UMCP_RequestContext.h"
+#include "UMCP_Metrics.h"
+#include "UMCP_ResponseCompression.h"
 #include "UnrealMCPServerModule.h"
 
 #include "HttpServerModule.h"
@@ -14,6 +18,10 @@
 #include "Serialization/JsonSerializer.h"
 #include "Engine/Engine.h"
 #include "Async/Async.h"
+#include "Misc/ScopeRWLock.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "IPAddress.h"
 
 
 const FString FUMCP_Server::MCP_PROTOCOL_VERSION = TEXT("2024-11-05");//TEXT("2025-03-26");
@@ -35,8 +43,12 @@ void FUMCP_Server::StartServer()
 #endif
 			[this](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete) -> bool
 			{
-				AsyncTask(ENamedThreads::GameThread, [this, Request, OnComplete]() {
-					this->HandleStreamableHTTPMCPRequest(Request, OnComplete);
+				// The router only lends us the request for this call, so take the one copy of the body here.
+				// Everything after this parses and slices that buffer in place.
+				TSharedRef<const FHttpServerRequest> SharedRequest = MakeShared<FHttpServerRequest>(Request);
+				// Parse on a worker; only handlers that need it are marshalled to the game thread
+				AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, SharedRequest, OnComplete]() {
+					this->HandleStreamableHTTPMCPRequest(SharedRequest, OnComplete);
 				});
 				return true;
 			}
@@ -44,7 +56,26 @@ void FUMCP_Server::StartServer()
 		)
 #endif
 		);
+	// GET resumes an event stream started by a POST, see FUMCP_EventStream
+	RouteHandle_MCPStreamableHTTPGet = HttpRouter->BindRoute(FHttpPath(TEXT("/mcp")), EHttpServerRequestVerbs::VERB_GET,
+#if (ENGINE_MAJOR_VERSION >= (5) && ENGINE_MINOR_VERSION >= (4))
+		FHttpRequestHandler::CreateLambda(
+#endif
+			[this](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete) -> bool
+			{
+				HandleStreamableHTTPMCPGetRequest(Request, OnComplete);
+				return true;
+			}
+#if (ENGINE_MAJOR_VERSION == (5) && ENGINE_MINOR_VERSION >= (5))
+		)
+#endif
+		);
+	// Event ids embed the stream id, seed it so ids from a previous run don't resume a different stream
+	NextEventStreamId = FPlatformTime::Cycles();
+	GameThreadScheduler->Start();
+	EventStreamTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FUMCP_Server::TickEventStreams));
 	RegisterInternalRpcMethodHandlers();
+	RegisterInternalResources();
 
 	UE_LOG(LogUnrealMCPServer, Log, TEXT("Bound /mcp to handler."));
 
@@ -63,51 +94,106 @@ void FUMCP_Server::StopServer()
 			HttpRouter->UnbindRoute(RouteHandle_MCPStreamableHTTP);
 			RouteHandle_MCPStreamableHTTP.Reset();
 		}
+		if (RouteHandle_MCPStreamableHTTPGet.IsValid())
+		{
+			HttpRouter->UnbindRoute(RouteHandle_MCPStreamableHTTPGet);
+			RouteHandle_MCPStreamableHTTPGet.Reset();
+		}
 
 		UE_LOG(LogUnrealMCPServer, Log, TEXT("All routes unbound."));
 		HttpRouter.Reset();
 	}
-	JsonRpcMethodHandlers.Empty();
+	{
+		// Dispatches already on worker threads may still be looking up their handlers
+		FWriteScopeLock WriteLock(RegistryLock);
+		JsonRpcMethodHandlers.Empty();
+	}
+
+	GameThreadScheduler->Stop();
+	{
+		// Anything still running has nobody left to answer
+		FScopeLock InFlightScopeLock(&InFlightLock);
+		for (TPair<FString, TSharedRef<FUMCP_CancellationToken>>& InFlight : InFlightRequests)
+		{
+			InFlight.Value->Cancel();
+		}
+		InFlightRequests.Empty();
+	}
+	if (EventStreamTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(EventStreamTickerHandle);
+		EventStreamTickerHandle.Reset();
+	}
+	{
+		FScopeLock EventStreamsScopeLock(&EventStreamsLock);
+		EventStreams.Empty();
+	}
 
 	// let the HttpServerModule clean itself up whenever it goes away.  Nothing to do here
 }
 
-void FUMCP_Server::RegisterRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcHandler&& Handler)
+void FUMCP_Server::RegisterRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity)
 {
-	JsonRpcMethodHandlers.Add(MethodName, Handler);
+	FWriteScopeLock WriteLock(RegistryLock);
+	JsonRpcMethodHandlers.Add(MethodName, FUMCP_JsonRpcMethod{ MoveTemp(Handler), nullptr, nullptr, ThreadAffinity });
+}
+
+void FUMCP_Server::SetRpcMethodPriority(const FString& MethodName, EUMCP_RequestPriority Priority)
+{
+	FWriteScopeLock WriteLock(RegistryLock);
+	if (FUMCP_JsonRpcMethod* Method = JsonRpcMethodHandlers.Find(MethodName))
+	{
+		Method->Priority = Priority;
+	}
+}
+
+void FUMCP_Server::RegisterAsyncRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcAsyncHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity)
+{
+	FWriteScopeLock WriteLock(RegistryLock);
+	JsonRpcMethodHandlers.Add(MethodName, FUMCP_JsonRpcMethod{ nullptr, nullptr, MoveTemp(Handler), ThreadAffinity });
+}
+
+void FUMCP_Server::RegisterEncodedRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcEncodedHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity)
+{
+	FWriteScopeLock WriteLock(RegistryLock);
+	JsonRpcMethodHandlers.Add(MethodName, FUMCP_JsonRpcMethod{ nullptr, MoveTemp(Handler), nullptr, ThreadAffinity });
 }
 
 bool FUMCP_Server::RegisterTool(FUMCP_ToolDefinition Tool)
 {
-	if (!Tool.DoToolCall.IsBound())
+	if (!Tool.DoToolCall.IsBound() && !Tool.DoToolCallAsync.IsBound())
 	{
 		return false;
 	}
+	FWriteScopeLock WriteLock(RegistryLock);
 	if (Tools.Contains(Tool.name))
 	{
 		return false;
 	}
 	Tools.Add(Tool.name, Tool);
+	++RegistryGeneration;
 	return true;
 }
 
 bool FUMCP_Server::RegisterResource(FUMCP_ResourceDefinition Resource)
 {
-	if (!Resource.ReadResource.IsBound())
+	if (!Resource.IsBound())
 	{
 		return false;
 	}
+	FWriteScopeLock WriteLock(RegistryLock);
 	if (Resources.Contains(Resource.uri))
 	{
 		return false;
 	}
 	Resources.Add(Resource.uri, Resource);
+	++RegistryGeneration;
 	return true;
 }
 
 bool FUMCP_Server::RegisterResourceTemplate(FUMCP_ResourceTemplateDefinition ResourceTemplate)
 {
-	if (!ResourceTemplate.ReadResource.IsBound())
+	if (!ResourceTemplate.IsBound())
 	{
 		return false;
 	}
@@ -117,88 +203,684 @@ bool FUMCP_Server::RegisterResourceTemplate(FUMCP_ResourceTemplateDefinition Res
 		return false;
 	}
 	
+	FWriteScopeLock WriteLock(RegistryLock);
 	ResourceTemplates.Emplace(MoveTemp(UriTemplate), MoveTemp(ResourceTemplate));
+	++RegistryGeneration;
 	return true;
 }
 
-// Helper to send a JSON response
-void FUMCP_Server::SendJsonRpcResponse(const FHttpResultCallback& OnComplete, const FUMCP_JsonRpcResponse& RpcResponse)
+namespace
+{
+	TAutoConsoleVariable<int32> CVarResponseCompressionMinBytes(
+		TEXT("UMCP.ResponseCompression.MinBytes"),
+		1024,
+		TEXT("Smallest JSON response compressed for clients that accept gzip or deflate, negative disables compression."));
+
+	const ANSICHAR* SerializeFailedPayload = "{\"jsonrpc\": \"2.0\", \"id\": null, \"error\": {\"code\": -32603, \"message\": \"Internal error - Failed to serialize response\"}}";
+}
+
+// Helper to send a JSON response, returns the size of the payload sent
+int32 FUMCP_Server::SendJsonRpcResponse(const FHttpResultCallback& OnComplete, const FUMCP_JsonRpcResponse& RpcResponse, EUMCP_ContentEncoding Encoding)
 {
-	FString JsonPayload;
-	if (!RpcResponse.ToJsonString(JsonPayload))
+	TArray<uint8> JsonPayload;
+	JsonPayload.Reserve(RpcResponse.EstimateJsonUtf8Size());
+	if (!RpcResponse.ToJsonUtf8(JsonPayload))
 	{
 		UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to serialize response."));
-		JsonPayload = TEXT("{\"jsonrpc\": \"2.0\", \"id\": null, \"error\": {\"code\": -32603, \"message\": \"Internal error - Failed to serialize response\"}}");
+		JsonPayload.Reset();
+		JsonPayload.Append(reinterpret_cast<const uint8*>(SerializeFailedPayload), FCStringAnsi::Strlen(SerializeFailedPayload));
 	}
+	const int32 PayloadBytes = JsonPayload.Num();
+	SendJsonPayload(OnComplete, MoveTemp(JsonPayload), Encoding);
+	return PayloadBytes;
+}
 
-	if (JsonPayload.Len() > 1000)
+// Helper to send the array response of a JSON-RPC batch, returns the size of the payload sent
+int32 FUMCP_Server::SendJsonRpcBatchResponse(const FHttpResultCallback& OnComplete, const TArray<FUMCP_JsonRpcResponse>& Responses, TArray<int32>* OutResponseSizes, EUMCP_ContentEncoding Encoding)
+{
+	int64 EstimatedSize = 2;
+	for (const FUMCP_JsonRpcResponse& Response : Responses)
 	{
-		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("SendJsonResponse: Payload received (truncated): %s"), *JsonPayload.Left(1000));
+		EstimatedSize += Response.EstimateJsonUtf8Size() + 1;
 	}
-	else
+	TArray<uint8> JsonPayload;
+	JsonPayload.Reserve(EstimatedSize);
+	JsonPayload.Add('[');
+	for (int32 Index = 0; Index < Responses.Num(); ++Index)
 	{
-		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("SendJsonResponse: Payload received: %s"), *JsonPayload);
+		if (Index > 0)
+		{
+			JsonPayload.Add(',');
+		}
+		const int32 ResponseStart = JsonPayload.Num();
+		if (!Responses[Index].ToJsonUtf8(JsonPayload))
+		{
+			UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to serialize batch response %d."), Index);
+			JsonPayload.SetNum(ResponseStart);
+			JsonPayload.Append(reinterpret_cast<const uint8*>(SerializeFailedPayload), FCStringAnsi::Strlen(SerializeFailedPayload));
+		}
+		if (OutResponseSizes)
+		{
+			OutResponseSizes->Add(JsonPayload.Num() - ResponseStart);
+		}
 	}
-    TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(JsonPayload, TEXT("application/json"));
-    Response->Code = EHttpServerResponseCodes::Ok; 
+	JsonPayload.Add(']');
+	const int32 PayloadBytes = JsonPayload.Num();
+	SendJsonPayload(OnComplete, MoveTemp(JsonPayload), Encoding);
+	return PayloadBytes;
+}
+
+void FUMCP_Server::SendJsonPayload(const FHttpResultCallback& OnComplete, TArray<uint8>&& JsonPayload, EUMCP_ContentEncoding Encoding)
+{
+	const int32 MinCompressBytes = CVarResponseCompressionMinBytes.GetValueOnAnyThread();
+	if (Encoding != EUMCP_ContentEncoding::Identity && (MinCompressBytes < 0 || JsonPayload.Num() < MinCompressBytes))
+	{
+		Encoding = EUMCP_ContentEncoding::Identity;
+	}
+	// Compressing a large result takes milliseconds, which the editor's frame shouldn't pay for
+	if (Encoding != EUMCP_ContentEncoding::Identity && IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [OnComplete, JsonPayload = MoveTemp(JsonPayload), Encoding]() mutable
+		{
+			SendJsonPayload(OnComplete, MoveTemp(JsonPayload), Encoding);
+		});
+		return;
+	}
+
+	if (UE_LOG_ACTIVE(LogUnrealMCPServer, Verbose))
+	{
+		const int32 LoggedBytes = FMath::Min(JsonPayload.Num(), 1000);
+		FUTF8ToTCHAR Convert(reinterpret_cast<const ANSICHAR*>(JsonPayload.GetData()), LoggedBytes);
+		const FString LoggedPayload(Convert.Length(), Convert.Get());
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("SendJsonResponse: Payload received%s: %s"), LoggedBytes < JsonPayload.Num() ? TEXT(" (truncated)") : TEXT(""), *LoggedPayload);
+	}
+	const bool bCompressed = FUMCP_ResponseCompression::Compress(Encoding, JsonPayload);
+    TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(MoveTemp(JsonPayload), TEXT("application/json"));
 
     if (!Response.IsValid())
     {
         UE_LOG(LogUnrealMCPServer, Error, TEXT("SendJsonResponse: FHttpServerResponse::Create failed to create a valid response object!"));
         return; 
     }
+    Response->Code = EHttpServerResponseCodes::Ok; 
+	if (bCompressed)
+	{
+		Response->Headers.Add(TEXT("Content-Encoding"), { FUMCP_ResponseCompression::GetHeaderValue(Encoding) });
+	}
+	// Caches between the client and the editor shouldn't hand a compressed reply to a client that didn't ask for one
+	Response->Headers.Add(TEXT("Vary"), { TEXT("Accept-Encoding") });
     
     UE_LOG(LogUnrealMCPServer, Verbose, TEXT("SendJsonResponse: Calling OnComplete. Response Code: %d"), Response->Code);
-    OnComplete(MoveTemp(Response));
+    CompleteOnGameThread(OnComplete, MoveTemp(Response));
 }
 
-// Main handler for MCP requests, runs on an HTTP thread
-void FUMCP_Server::HandleStreamableHTTPMCPRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+// Notification-only posts have nothing to reply with
+void FUMCP_Server::SendAccepted(const FHttpResultCallback& OnComplete)
 {
-	FUTF8ToTCHAR Convert((ANSICHAR*)Request.Body.GetData(), Request.Body.Num());
-	FString RequestBody(Convert.Length(), Convert.Get());
-    UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Received MCP request: %s"), *RequestBody);
-	
+	TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+	Response->Code = EHttpServerResponseCodes::Accepted;
+	CompleteOnGameThread(OnComplete, MoveTemp(Response));
+}
+
+// The HTTP listener is ticked on the game thread, so responses are handed back there
+void FUMCP_Server::CompleteOnGameThread(const FHttpResultCallback& OnComplete, TUniquePtr<FHttpServerResponse>&& Response)
+{
+	if (IsInGameThread())
+	{
+		OnComplete(MoveTemp(Response));
+		return;
+	}
+	AsyncTask(ENamedThreads::GameThread, [OnComplete, Response = MoveTemp(Response)]() mutable
+	{
+		OnComplete(MoveTemp(Response));
+	});
+}
+
+namespace
+{
+	// Request bodies can be huge, so logs only ever get the start of them
+	FString DescribeRequestBody(const TArray<uint8>& Body)
+	{
+		const int32 LoggedBytes = FMath::Min(Body.Num(), 256);
+		FUTF8ToTCHAR Convert(reinterpret_cast<const ANSICHAR*>(Body.GetData()), LoggedBytes);
+		return FString::Printf(TEXT("%d bytes: %s%s"), Body.Num(), *FString(Convert.Length(), Convert.Get()), LoggedBytes < Body.Num() ? TEXT("...") : TEXT(""));
+	}
+
+	// Header names are case-insensitive, so don't rely on the casing the client used
+	FString FindRequestHeader(const FHttpServerRequest& Request, const FString& HeaderName)
+	{
+		for (const TPair<FString, TArray<FString>>& Header : Request.Headers)
+		{
+			if (Header.Key.Equals(HeaderName, ESearchCase::IgnoreCase))
+			{
+				return FString::Join(Header.Value, TEXT(","));
+			}
+		}
+		return FString();
+	}
+}
+
+// Main handler for MCP requests, runs on a background worker
+void FUMCP_Server::HandleStreamableHTTPMCPRequest(const TSharedRef<const FHttpServerRequest>& Request, const FHttpResultCallback& OnComplete)
+{
+	if (UE_LOG_ACTIVE(LogUnrealMCPServer, Verbose))
+	{
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Received MCP request: %s"), *DescribeRequestBody(Request->Body));
+	}
+
+	// Aliases the request so entry views keep it alive without copying the body again
+	const TSharedPtr<const TArray<uint8>> Body(Request, &Request->Body);
+
 	FUMCP_JsonRpcResponse Response;
+	TArray<FUMCP_JsonUtf8View> Entries;
+	bool bIsBatch = false;
+	const double ParseStartTime = FPlatformTime::Seconds();
+	const bool bSplit = UMCP_SplitJsonUtf8Body(Body, Entries, bIsBatch);
+	Metrics->RecordHttpRequest(Body->Num(), FPlatformTime::Seconds() - ParseStartTime);
+	if (!bSplit)
+	{
+		UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to parse MCP request JSON (%s)"), *DescribeRequestBody(Request->Body));
+		Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::ParseError, TEXT("Failed to parse MCP request JSON"));
+		SendJsonRpcResponse(OnComplete, Response);
+		return;
+	}
 
-    FUMCP_JsonRpcRequest RpcRequest;
-    if (!FUMCP_JsonRpcRequest::CreateFromJsonString(RequestBody, RpcRequest))
-    {
-        UE_LOG(LogUnrealMCPServer, Error, TEXT("Failed to parse MCP request JSON: %s"), *RequestBody);
-    	Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::ParseError, TEXT("Failed to parse MCP request JSON"));
-        SendJsonRpcResponse(OnComplete, Response);
-        return;
-    }
+	// A JSON array is a JSON-RPC batch, answered with a single array response
+	if (bIsBatch && Entries.IsEmpty())
+	{
+		Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InvalidRequest, TEXT("Invalid Request - empty batch"));
+		SendJsonRpcResponse(OnComplete, Response);
+		return;
+	}
+
+	// Clients that can take an event stream get one, so long running requests can report back before they finish
+	const bool bAcceptsEventStream = FindRequestHeader(*Request, TEXT("Accept")).Contains(TEXT("text/event-stream"));
+	const bool bHasSessionId = !FindRequestHeader(*Request, TEXT("Mcp-Session-Id")).IsEmpty();
+	// Event streams are written as they go, only whole JSON replies are compressed
+	const EUMCP_ContentEncoding ContentEncoding = FUMCP_ResponseCompression::Negotiate(FindRequestHeader(*Request, TEXT("Accept-Encoding")));
+	DispatchRpcEntries(Entries, bIsBatch, bAcceptsEventStream, ContentEncoding, GetSessionKey(*Request), bHasSessionId, OnComplete);
+}
+
+FString FUMCP_Server::GetSessionKey(const FHttpServerRequest& Request)
+{
+	FString SessionKey = FindRequestHeader(Request, TEXT("Mcp-Session-Id"));
+	// Clients open a new connection whenever they like, so only the host stays the same between a request and its cancellation
+	if (SessionKey.IsEmpty() && Request.PeerAddress.IsValid())
+	{
+		SessionKey = Request.PeerAddress->ToString(false);
+	}
+	return SessionKey;
+}
+
+// Resumes an event stream from the Last-Event-ID the client received. Runs on the game thread.
+void FUMCP_Server::HandleStreamableHTTPMCPGetRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	const FString LastEventId = FindRequestHeader(Request, TEXT("Last-Event-ID"));
+	if (LastEventId.IsEmpty())
+	{
+		// There are no server initiated messages, so there is no standalone stream to open
+		TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+		Response->Code = EHttpServerResponseCodes::BadMethod;
+		OnComplete(MoveTemp(Response));
+		return;
+	}
+
+	uint32 StreamId = 0;
+	uint32 Sequence = 0;
+	TSharedPtr<FUMCP_EventStream> EventStream;
+	if (FUMCP_EventStream::ParseEventId(LastEventId, StreamId, Sequence))
+	{
+		FScopeLock EventStreamsScopeLock(&EventStreamsLock);
+		EventStream = EventStreams.FindRef(StreamId);
+	}
+	if (!EventStream.IsValid())
+	{
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("No event stream to resume for Last-Event-ID '%s'."), *LastEventId);
+		TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+		Response->Code = EHttpServerResponseCodes::NotFound;
+		OnComplete(MoveTemp(Response));
+		return;
+	}
+	EventStream->AddPoller(Sequence, OnComplete);
+}
+
+FString FUMCP_Server::GetInFlightKey(const FString& SessionKey, const FUMCP_JsonRpcId& RequestId)
+{
+	// Ids are only unique per client, and "1" is a different id than 1
+	return FString::Printf(TEXT("%s|%c%s"), *SessionKey, RequestId.IsString() ? TEXT('s') : TEXT('n'), *RequestId.ToString());
+}
+
+void FUMCP_Server::TrackInFlightRequest(const FUMCP_RequestContext& Context)
+{
+	FScopeLock InFlightScopeLock(&InFlightLock);
+	InFlightRequests.Add(GetInFlightKey(Context.GetSessionKey(), Context.GetRequestId()), Context.GetCancellationToken());
+}
+
+void FUMCP_Server::UntrackInFlightRequest(const FUMCP_RequestContext& Context)
+{
+	const FString Key = GetInFlightKey(Context.GetSessionKey(), Context.GetRequestId());
+	FScopeLock InFlightScopeLock(&InFlightLock);
+	// A client reusing an id while the first request still runs replaces it, so only remove our own token
+	const TSharedRef<FUMCP_CancellationToken>* Token = InFlightRequests.Find(Key);
+	if (Token && *Token == Context.GetCancellationToken())
+	{
+		InFlightRequests.Remove(Key);
+	}
+}
+
+TSharedRef<FUMCP_EventStream> FUMCP_Server::CreateEventStream()
+{
+	FScopeLock EventStreamsScopeLock(&EventStreamsLock);
+	TSharedRef<FUMCP_EventStream> EventStream = MakeShared<FUMCP_EventStream>(NextEventStreamId++);
+	EventStreams.Add(EventStream->GetStreamId(), EventStream);
+	return EventStream;
+}
+
+bool FUMCP_Server::TickEventStreams(float DeltaTime)
+{
+	TArray<TSharedPtr<FUMCP_EventStream>> Streams;
+	{
+		FScopeLock EventStreamsScopeLock(&EventStreamsLock);
+		EventStreams.GenerateValueArray(Streams);
+	}
+
+	// Answering pollers happens outside the map lock, the callbacks go straight into the HTTP server
+	const double Now = FPlatformTime::Seconds();
+	for (const TSharedPtr<FUMCP_EventStream>& EventStream : Streams)
+	{
+		if (EventStream->Tick(Now))
+		{
+			FScopeLock EventStreamsScopeLock(&EventStreamsLock);
+			EventStreams.Remove(EventStream->GetStreamId());
+		}
+	}
+	return true;
+}
+
+// Shared state for the entries of one POST. Entries complete on different threads, the last one sends the reply.
+struct FUMCP_Server::FPendingRpcEntries
+{
+	FHttpResultCallback OnComplete;
+	TArray<FUMCP_JsonRpcResponse> Responses;
+	TArray<bool> HasResponse; // false for notifications, which are left out of the reply
+	FThreadSafeCounter Remaining;
+	bool bIsBatch = false;
+	EUMCP_ContentEncoding ContentEncoding = EUMCP_ContentEncoding::Identity;
+	// Set when the reply goes out as an event stream, responses are pushed to it as each entry finishes
+	TSharedPtr<FUMCP_EventStream> EventStream;
+	TSharedPtr<FUMCP_Metrics> Metrics;
+	TArray<FString> Methods; // Empty for entries that are not valid requests
+	TArray<int32> RequestBytes;
+};
+
+void FUMCP_Server::SendPendingResponses(FPendingRpcEntries& Pending)
+{
+	TArray<FUMCP_JsonRpcResponse> Replies;
+	TArray<FString> ReplyMethods;
+	for (int32 Index = 0; Index < Pending.Responses.Num(); ++Index)
+	{
+		if (Pending.HasResponse[Index])
+		{
+			Replies.Add(MoveTemp(Pending.Responses[Index]));
+			ReplyMethods.Add(Pending.Methods[Index]);
+		}
+	}
+
+	if (Replies.IsEmpty())
+	{
+		SendAccepted(Pending.OnComplete);
+		return;
+	}
+
+	const double SerializeStartTime = FPlatformTime::Seconds();
+	TArray<int32> ReplySizes;
+	int32 PayloadBytes = 0;
+	if (Pending.bIsBatch)
+	{
+		PayloadBytes = SendJsonRpcBatchResponse(Pending.OnComplete, Replies, &ReplySizes, Pending.ContentEncoding);
+	}
+	else
+	{
+		PayloadBytes = SendJsonRpcResponse(Pending.OnComplete, Replies[0], Pending.ContentEncoding);
+		ReplySizes.Add(PayloadBytes);
+	}
+	Pending.Metrics->RecordHttpResponse(PayloadBytes, FPlatformTime::Seconds() - SerializeStartTime);
+	for (int32 ReplyIndex = 0; ReplyIndex < ReplySizes.Num(); ++ReplyIndex)
+	{
+		if (!ReplyMethods[ReplyIndex].IsEmpty())
+		{
+			Pending.Metrics->RecordMethodResponseBytes(ReplyMethods[ReplyIndex], ReplySizes[ReplyIndex]);
+		}
+	}
+}
+
+void FUMCP_Server::DispatchRpcEntries(const TArray<FUMCP_JsonUtf8View>& Entries, bool bIsBatch, bool bAcceptsEventStream, EUMCP_ContentEncoding ContentEncoding, const FString& SessionKey, bool bHasSessionId, const FHttpResultCallback& OnComplete)
+{
+	TSharedRef<FPendingRpcEntries> Pending = MakeShared<FPendingRpcEntries>();
+	Pending->bIsBatch = bIsBatch;
+	Pending->ContentEncoding = ContentEncoding;
+	Pending->Responses.SetNum(Entries.Num());
+	Pending->HasResponse.Init(true, Entries.Num());
+	Pending->Remaining.Set(Entries.Num());
+	Pending->Metrics = Metrics;
+	Pending->Methods.SetNum(Entries.Num());
+	Pending->RequestBytes.SetNum(Entries.Num());
+	const double DispatchTime = FPlatformTime::Seconds();
+
+	if (bIsBatch)
+	{
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Handling JSON-RPC batch of %d entries."), Entries.Num());
+	}
+
+	TArray<FUMCP_JsonRpcRequest> Requests;
+	Requests.SetNum(Entries.Num());
+	TArray<bool> IsValidEntry;
+	IsValidEntry.Init(false, Entries.Num());
+	bool bHasRequests = false;
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (!FUMCP_JsonRpcRequest::CreateFromJsonUtf8(Entries[Index], Requests[Index]))
+		{
+			UE_LOG(LogUnrealMCPServer, Warning, TEXT("Invalid MCP request object at index %d."), Index);
+			Pending->Responses[Index].error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InvalidRequest, TEXT("Invalid Request - expected a JSON-RPC request object"));
+			bHasRequests = true;
+			continue;
+		}
+		IsValidEntry[Index] = true;
+		Pending->Methods[Index] = Requests[Index].method;
+		Pending->RequestBytes[Index] = Entries[Index].Length;
+		Pending->HasResponse[Index] = !Requests[Index].IsNotification();
+		bHasRequests |= Pending->HasResponse[Index];
+	}
+
+	// Clients without a session are issued one by their initialize, as Streamable HTTP specifies, and send it back from then on
+	FString EntrySessionKey = SessionKey;
+	Pending->OnComplete = OnComplete;
+	if (!bHasSessionId && Requests.ContainsByPredicate([](const FUMCP_JsonRpcRequest& Request) { return Request.method == TEXT("initialize"); }))
+	{
+		EntrySessionKey = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphensLower);
+		Pending->OnComplete = [OnComplete, SessionId = EntrySessionKey](TUniquePtr<FHttpServerResponse>&& Response)
+		{
+			Response->Headers.Add(TEXT("Mcp-Session-Id"), { SessionId });
+			OnComplete(MoveTemp(Response));
+		};
+	}
+
+	// Only posts that expect a response can be answered with a stream, notifications alone still get a plain 202
+	if (bAcceptsEventStream && bHasRequests)
+	{
+		Pending->EventStream = CreateEventStream();
+		Pending->EventStream->AddPoller(0, Pending->OnComplete);
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Answering with event stream %u."), Pending->EventStream->GetStreamId());
+	}
+
+	auto FinishEntry = [Pending](int32 Index)
+	{
+		if (Pending->EventStream.IsValid() && Pending->HasResponse[Index])
+		{
+			const double SerializeStartTime = FPlatformTime::Seconds();
+			const int32 ResponseBytes = Pending->EventStream->PushResponse(Pending->Responses[Index]);
+			Pending->Metrics->RecordHttpResponse(ResponseBytes, FPlatformTime::Seconds() - SerializeStartTime);
+			if (!Pending->Methods[Index].IsEmpty())
+			{
+				Pending->Metrics->RecordMethodResponseBytes(Pending->Methods[Index], ResponseBytes);
+			}
+		}
+		if (Pending->Remaining.Decrement() != 0)
+		{
+			return;
+		}
+		if (Pending->EventStream.IsValid())
+		{
+			Pending->EventStream->Close();
+			return;
+		}
+		// Keep serialization off the game thread
+		if (IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Pending]()
+			{
+				SendPendingResponses(*Pending);
+			});
+			return;
+		}
+		SendPendingResponses(*Pending);
+	};
+
+	TArray<TSharedPtr<FUMCP_RequestContext>> Contexts;
+	Contexts.SetNum(Entries.Num());
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (IsValidEntry[Index])
+		{
+			Contexts[Index] = MakeShared<FUMCP_RequestContext>(Requests[Index], Pending->EventStream, EntrySessionKey);
+			if (Pending->HasResponse[Index])
+			{
+				TrackInFlightRequest(*Contexts[Index]);
+			}
+		}
+	}
+
+	// Handlers may answer later and from any thread, each entry finishes whenever its response arrives.
+	// The callback is made just as the handler starts, which is where queue wait ends and execution begins.
+	auto StoreResponse = [this, Pending, FinishEntry, DispatchTime](int32 Index, const TSharedRef<FUMCP_RequestContext>& Context) -> FUMCP_JsonRpcResponseCallback
+	{
+		return [this, Pending, FinishEntry, Index, Context, DispatchTime, ExecuteStartTime = FPlatformTime::Seconds()](FUMCP_JsonRpcResponse&& Response)
+		{
+			FUMCP_Metrics::FCallTiming Timing;
+			Timing.QueueWaitSeconds = ExecuteStartTime - DispatchTime;
+			Timing.ExecuteSeconds = FPlatformTime::Seconds() - ExecuteStartTime;
+			Pending->Metrics->RecordMethodCall(Pending->Methods[Index], Pending->RequestBytes[Index], Timing, Response.error.IsValid(), Context->IsCancelled());
+
+			if (Pending->HasResponse[Index])
+			{
+				UntrackInFlightRequest(*Context);
+				// The client has already given up on a cancelled request, so it gets no response
+				if (Context->IsCancelled())
+				{
+					UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Dropped the response to cancelled request %s."), *Context->GetRequestId().ToString());
+					Pending->HasResponse[Index] = false;
+				}
+			}
+			Pending->Responses[Index] = MoveTemp(Response);
+			FinishEntry(Index);
+		};
+	};
+
+	TArray<int32> InlineEntries;
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (!IsValidEntry[Index])
+		{
+			FinishEntry(Index);
+			continue;
+		}
+
+		TSharedRef<FUMCP_RequestContext> Context = Contexts[Index].ToSharedRef();
+		switch (GetRequestAffinity(Requests[Index]))
+		{
+		case EUMCP_ThreadAffinity::GameThread:
+		{
+			// Queued rather than run straight away, so bursts are spread over frames
+			const EUMCP_RequestPriority Priority = GetRequestPriority(Requests[Index]);
+			FUMCP_JsonRpcId RequestId = Requests[Index].id;
+			GameThreadScheduler->Enqueue(EntrySessionKey, Priority, [this, StoreResponse, Index, Context, RpcRequest = MoveTemp(Requests[Index])]()
+			{
+				if (Context->IsCancelled())
+				{
+					// Cancelled while it waited, not worth a frame
+					StoreResponse(Index, Context)(FUMCP_JsonRpcResponse());
+					return;
+				}
+				ExecuteRpcRequest(RpcRequest, Context, StoreResponse(Index, Context));
+			},
+			[StoreResponse, Index, Context, RequestId = MoveTemp(RequestId)]()
+			{
+				// The server is stopping before this got its turn, the client still gets an answer
+				FUMCP_JsonRpcResponse Response;
+				Response.id = RequestId;
+				Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InternalError, TEXT("Server is shutting down"));
+				StoreResponse(Index, Context)(MoveTemp(Response));
+			});
+			break;
+		}
+		case EUMCP_ThreadAffinity::WorkerPool:
+			AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, StoreResponse, Index, Context, RpcRequest = MoveTemp(Requests[Index])]()
+			{
+				if (Context->IsCancelled())
+				{
+					StoreResponse(Index, Context)(FUMCP_JsonRpcResponse());
+					return;
+				}
+				ExecuteRpcRequest(RpcRequest, Context, StoreResponse(Index, Context));
+			});
+			break;
+		case EUMCP_ThreadAffinity::AnyThread:
+		default:
+			InlineEntries.Add(Index);
+			break;
+		}
+	}
+
+	// Cheap entries run right here while the others are in flight
+	for (int32 Index : InlineEntries)
+	{
+		TSharedRef<FUMCP_RequestContext> Context = Contexts[Index].ToSharedRef();
+		ExecuteRpcRequest(Requests[Index], Context, StoreResponse(Index, Context));
+	}
+}
+
+EUMCP_ThreadAffinity FUMCP_Server::GetRequestAffinity(const FUMCP_JsonRpcRequest& RpcRequest) const
+{
+	FReadScopeLock ReadLock(RegistryLock);
+	const FUMCP_JsonRpcMethod* Method = JsonRpcMethodHandlers.Find(RpcRequest.method);
+	if (!Method)
+	{
+		// Replied to with MethodNotFound, no need to go anywhere
+		return EUMCP_ThreadAffinity::AnyThread;
+	}
+
+	// Tool calls and resource reads take on the affinity of the tool or resource they target
+	// Only the target name is read here, the params DOM is built later by whoever runs the handler
+	if (RpcRequest.method == TEXT("tools/call"))
+	{
+		FString ToolName;
+		if (RpcRequest.TryGetParamsStringField(TEXT("name"), ToolName))
+		{
+			if (const FUMCP_ToolDefinition* Tool = Tools.Find(ToolName))
+			{
+				return Tool->ThreadAffinity;
+			}
+		}
+	}
+	else if (RpcRequest.method == TEXT("resources/read"))
+	{
+		FString Uri;
+		if (RpcRequest.TryGetParamsStringField(TEXT("uri"), Uri))
+		{
+			if (const FUMCP_ResourceDefinition* Resource = Resources.Find(Uri))
+			{
+				return Resource->ThreadAffinity;
+			}
+			for (const auto& ResourceTemplate : ResourceTemplates)
+			{
+				FUMCP_UriTemplateMatch Match;
+				if (ResourceTemplate.Key.FindMatch(Uri, Match))
+				{
+					return ResourceTemplate.Value.ThreadAffinity;
+				}
+			}
+		}
+	}
+	return Method->ThreadAffinity;
+}
+
+EUMCP_RequestPriority FUMCP_Server::GetRequestPriority(const FUMCP_JsonRpcRequest& RpcRequest) const
+{
+	FReadScopeLock ReadLock(RegistryLock);
+	const FUMCP_JsonRpcMethod* Method = JsonRpcMethodHandlers.Find(RpcRequest.method);
+	return Method ? Method->Priority : EUMCP_RequestPriority::Normal;
+}
+
+void FUMCP_Server::ExecuteRpcRequest(const FUMCP_JsonRpcRequest& RpcRequest, const TSharedRef<FUMCP_RequestContext>& Context, FUMCP_JsonRpcResponseCallback&& OnResponse)
+{
+	FUMCP_JsonRpcResponse Response;
 	Response.id = RpcRequest.id;
 
     if (RpcRequest.jsonrpc != TEXT("2.0"))
     {
         UE_LOG(LogUnrealMCPServer, Error, TEXT("Invalid JSON-RPC version: %s"), *RpcRequest.jsonrpc);
 		Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InvalidRequest, TEXT("Invalid Request - JSON-RPC version must be 2.0"));
-        SendJsonRpcResponse(OnComplete, Response);
+        OnResponse(MoveTemp(Response));
         return;
     }
 
-	UMCP_JsonRpcHandler* Handler = JsonRpcMethodHandlers.Find(RpcRequest.method);
-	if (!Handler)
+	UMCP_JsonRpcHandler Handler;
+	UMCP_JsonRpcEncodedHandler EncodedHandler;
+	UMCP_JsonRpcAsyncHandler AsyncHandler;
+	{
+		FReadScopeLock ReadLock(RegistryLock);
+		if (const FUMCP_JsonRpcMethod* Method = JsonRpcMethodHandlers.Find(RpcRequest.method))
+		{
+			Handler = Method->Handler;
+			EncodedHandler = Method->EncodedHandler;
+			AsyncHandler = Method->AsyncHandler;
+		}
+	}
+	if (!Handler && !EncodedHandler && !AsyncHandler)
 	{
         UE_LOG(LogUnrealMCPServer, Warning, TEXT("Unknown MCP method received: %s"), *RpcRequest.method);
 		Response.error = MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::MethodNotFound, TEXT("Method not found"));
-		SendJsonRpcResponse(OnComplete, Response);
+		OnResponse(MoveTemp(Response));
+		return;
+	}
+
+	// Lets tools and resource readers reach the request, e.g. to report progress or check for cancellation
+	FUMCP_RequestContextScope ContextScope(*Context);
+
+	if (AsyncHandler)
+	{
+		AsyncHandler(RpcRequest, [Method = RpcRequest.method, Id = RpcRequest.id, OnResponse = MoveTemp(OnResponse)](TSharedPtr<FJsonObject> Result, TSharedPtr<FUMCP_JsonRpcError> Error)
+		{
+			FUMCP_JsonRpcResponse AsyncResponse;
+			AsyncResponse.id = Id;
+			if (Error.IsValid())
+			{
+				UE_LOG(LogUnrealMCPServer, Warning, TEXT("Error handling '%s': (%d) %s"), *Method, Error->code, *Error->message);
+				AsyncResponse.error = MoveTemp(Error);
+			}
+			else
+			{
+				AsyncResponse.result = MakeShared<FJsonValueObject>(Result.IsValid() ? Result : MakeShared<FJsonObject>());
+			}
+			OnResponse(MoveTemp(AsyncResponse));
+		});
 		return;
 	}
 
-	auto SuccessObject = MakeShared<FJsonObject>();
 	auto ErrorObject = MakeShared<FUMCP_JsonRpcError>();
-	if (!(*Handler)(RpcRequest, SuccessObject, *ErrorObject))
+	if (EncodedHandler)
+	{
+		if (!EncodedHandler(RpcRequest, Response.encodedResult, *ErrorObject))
+		{
+			UE_LOG(LogUnrealMCPServer, Warning, TEXT("Error handling '%s': (%d) %s"), *RpcRequest.method, ErrorObject->code, *ErrorObject->message);
+			Response.encodedResult.Reset();
+			Response.error = MoveTemp(ErrorObject);
+		}
+		OnResponse(MoveTemp(Response));
+		return;
+	}
+
+	auto SuccessObject = MakeShared<FJsonObject>();
+	if (!Handler(RpcRequest, SuccessObject, *ErrorObject))
 	{
 		UE_LOG(LogUnrealMCPServer, Warning, TEXT("Error handling '%s': (%d) %s"), *RpcRequest.method, ErrorObject->code, *ErrorObject->message);
 		Response.error = MoveTemp(ErrorObject);
-		SendJsonRpcResponse(OnComplete, Response);
+		OnResponse(MoveTemp(Response));
 		return;
 	}
 	Response.result = MakeShared<FJsonValueObject>(MoveTemp(SuccessObject));
-	SendJsonRpcResponse(OnComplete, Response);
+	OnResponse(MoveTemp(Response));
 }
 
 void FUMCP_Server::RegisterInternalRpcMethodHandlers()
@@ -207,45 +889,139 @@ void FUMCP_Server::RegisterInternalRpcMethodHandlers()
 	RegisterRpcMethodHandler(TEXT("initialize"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 	{
 		return Rpc_Initialize(Request, OutSuccess, OutError);
-	});
+	}, EUMCP_ThreadAffinity::AnyThread);
 	RegisterRpcMethodHandler(TEXT("ping"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 	{
 		return Rpc_Ping(Request, OutSuccess, OutError);
-	});
+	}, EUMCP_ThreadAffinity::AnyThread);
 	RegisterRpcMethodHandler(TEXT("notifications/initialized"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 	{
 		return Rpc_ClientNotifyInitialized(Request, OutSuccess, OutError);
-	});
+	}, EUMCP_ThreadAffinity::AnyThread);
+	RegisterRpcMethodHandler(TEXT("notifications/cancelled"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+	{
+		return Rpc_ClientNotifyCancelled(Request, OutSuccess, OutError);
+	}, EUMCP_ThreadAffinity::AnyThread);
 
 	// Tools
-	RegisterRpcMethodHandler(TEXT("tools/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+	RegisterEncodedRpcMethodHandler(TEXT("tools/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError)
 	{
-		return Rpc_ToolsList(Request, OutSuccess, OutError);
-	});
-	RegisterRpcMethodHandler(TEXT("tools/call"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+		return GetCachedResult(ToolsListCache, Request, [this](const FUMCP_JsonRpcRequest& ListRequest, TSharedPtr<FJsonObject> OutListResult, FUMCP_JsonRpcError& OutListError)
+		{
+			return Rpc_ToolsList(ListRequest, OutListResult, OutListError);
+		}, OutEncodedResult, OutError);
+	}, EUMCP_ThreadAffinity::AnyThread);
+	// tools/call and resources/read run wherever their target tool or resource asks for, see GetRequestAffinity
+	RegisterAsyncRpcMethodHandler(TEXT("tools/call"), [this](const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete)
 	{
-		return Rpc_ToolsCall(Request, OutSuccess, OutError);
-	});
+		Rpc_ToolsCall(Request, MoveTemp(OnComplete));
+	}, EUMCP_ThreadAffinity::AnyThread);
 
 	// Resources
-	RegisterRpcMethodHandler(TEXT("resources/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+	RegisterEncodedRpcMethodHandler(TEXT("resources/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError)
 	{
-		return Rpc_ResourcesList(Request, OutSuccess, OutError);
-	});
-	RegisterRpcMethodHandler(TEXT("resources/templates/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+		return GetCachedResult(ResourcesListCache, Request, [this](const FUMCP_JsonRpcRequest& ListRequest, TSharedPtr<FJsonObject> OutListResult, FUMCP_JsonRpcError& OutListError)
+		{
+			return Rpc_ResourcesList(ListRequest, OutListResult, OutListError);
+		}, OutEncodedResult, OutError);
+	}, EUMCP_ThreadAffinity::AnyThread);
+	RegisterEncodedRpcMethodHandler(TEXT("resources/templates/list"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError)
 	{
-		return Rpc_ResourcesTemplatesList(Request, OutSuccess, OutError);
-	});
-	RegisterRpcMethodHandler(TEXT("resources/read"), [this](const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+		return GetCachedResult(ResourceTemplatesListCache, Request, [this](const FUMCP_JsonRpcRequest& ListRequest, TSharedPtr<FJsonObject> OutListResult, FUMCP_JsonRpcError& OutListError)
+		{
+			return Rpc_ResourcesTemplatesList(ListRequest, OutListResult, OutListError);
+		}, OutEncodedResult, OutError);
+	}, EUMCP_ThreadAffinity::AnyThread);
+	RegisterAsyncRpcMethodHandler(TEXT("resources/read"), [this](const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete)
 	{
-		return Rpc_ResourcesRead(Request, OutSuccess, OutError);
-	});
+		Rpc_ResourcesRead(Request, MoveTemp(OnComplete));
+	}, EUMCP_ThreadAffinity::AnyThread);
+
+	// Tool calls are the heavy hitters, reads of single resources come before them.
+	// The cheap methods run off the game thread anyway, but should they ever queue they go first.
+	for (const TCHAR* CheapMethod : { TEXT("initialize"), TEXT("ping"), TEXT("notifications/initialized"), TEXT("notifications/cancelled"), TEXT("tools/list"), TEXT("resources/list"), TEXT("resources/templates/list") })
+	{
+		SetRpcMethodPriority(CheapMethod, EUMCP_RequestPriority::High);
+	}
+	SetRpcMethodPriority(TEXT("tools/call"), EUMCP_RequestPriority::Low);
+	SetRpcMethodPriority(TEXT("resources/read"), EUMCP_RequestPriority::Normal);
+}
+
+void FUMCP_Server::RegisterInternalResources()
+{
+	FUMCP_ResourceDefinition MetricsResource;
+	MetricsResource.name = TEXT("Server Metrics");
+	MetricsResource.description = TEXT("Request counts, error counts, payload sizes and latency percentiles of this MCP server, per method and per tool.");
+	MetricsResource.mimeType = TEXT("application/json");
+	MetricsResource.uri = TEXT("unreal+metrics://server");
+	MetricsResource.ReadResource.BindRaw(this, &FUMCP_Server::ReadMetricsResource);
+	MetricsResource.ThreadAffinity = EUMCP_ThreadAffinity::AnyThread;
+	if (!RegisterResource(MoveTemp(MetricsResource)))
+	{
+		UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Metrics resource already registered."));
+	}
+}
+
+bool FUMCP_Server::ReadMetricsResource(const FString& Uri, TArray<FUMCP_ReadResourceResultContent>& OutContent)
+{
+	TSharedRef<FJsonObject> MetricsJson = Metrics->ToJson();
+	TSharedRef<FJsonObject> QueueJson = MakeShared<FJsonObject>();
+	QueueJson->SetNumberField(TEXT("depth"), GameThreadScheduler->GetQueueDepth());
+	QueueJson->SetNumberField(TEXT("lastMaxWaitMs"), GameThreadScheduler->GetLastMaxWaitMs());
+	QueueJson->SetNumberField(TEXT("averageWaitMs"), GameThreadScheduler->GetAverageWaitMs());
+	MetricsJson->SetObjectField(TEXT("gameThreadQueue"), QueueJson);
+
+	auto& Content = OutContent.AddDefaulted_GetRef();
+	Content.uri = Uri;
+	Content.mimeType = TEXT("application/json");
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Content.text);
+	return FJsonSerializer::Serialize(MetricsJson, Writer);
+}
+
+bool FUMCP_Server::GetCachedResult(FEncodedResultCache& Cache, const FUMCP_JsonRpcRequest& Request, const UMCP_JsonRpcHandler& BuildResult, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError)
+{
+	// Read the generation before building, so a registration racing with the build only ever causes a rebuild
+	uint32 Generation;
+	{
+		FReadScopeLock ReadLock(RegistryLock);
+		Generation = RegistryGeneration;
+	}
+	{
+		FScopeLock CacheLock(&ResultCacheLock);
+		if (Cache.EncodedResult.IsValid() && Cache.Generation == Generation)
+		{
+			OutEncodedResult = Cache.EncodedResult;
+			return true;
+		}
+	}
+
+	auto SuccessObject = MakeShared<FJsonObject>();
+	if (!BuildResult(Request, SuccessObject, OutError))
+	{
+		return false;
+	}
+
+	TSharedRef<TArray<uint8>> EncodedResult = MakeShared<TArray<uint8>>();
+	EncodedResult->Reserve(FUMCP_JsonUtf8Writer::EstimateSize(*SuccessObject));
+	FUMCP_JsonUtf8Writer(*EncodedResult).WriteObject(*SuccessObject);
+	UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Rebuilt cached '%s' result for registry generation %u (%d bytes)."), *Request.method, Generation, EncodedResult->Num());
+
+	{
+		FScopeLock CacheLock(&ResultCacheLock);
+		if (!Cache.EncodedResult.IsValid() || Generation >= Cache.Generation)
+		{
+			Cache.Generation = Generation;
+			Cache.EncodedResult = EncodedResult;
+		}
+	}
+	OutEncodedResult = MoveTemp(EncodedResult);
+	return true;
 }
 
 bool FUMCP_Server::Rpc_Initialize(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 {
 	FUMCP_InitializeParams Params;
-	if (!UMCP_CreateFromJsonObject(Request.params, Params))
+	if (!UMCP_CreateFromJsonObject(Request.GetParams(), Params))
 	{
 		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
 		OutError.message = TEXT("Failed to parse 'initialize' params");
@@ -284,10 +1060,39 @@ bool FUMCP_Server::Rpc_ClientNotifyInitialized(const FUMCP_JsonRpcRequest& Reque
 	return true;
 }
 
+bool FUMCP_Server::Rpc_ClientNotifyCancelled(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+{
+	TSharedPtr<FJsonObject> Params = Request.GetParams();
+	TSharedPtr<FJsonValue> RequestIdValue = Params.IsValid() ? Params->TryGetField(TEXT("requestId")) : nullptr;
+	FUMCP_JsonRpcId CancelledId = FUMCP_JsonRpcId::CreateFromJsonValue(RequestIdValue);
+	if (!CancelledId.IsString() && !CancelledId.IsNumber())
+	{
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("notifications/cancelled without a valid requestId."));
+		return true;
+	}
+
+	FString Reason;
+	Params->TryGetStringField(TEXT("reason"), Reason);
+	const FUMCP_RequestContext* Context = FUMCP_RequestContext::GetCurrent();
+	const FString Key = GetInFlightKey(Context ? Context->GetSessionKey() : FString(), CancelledId);
+	{
+		FScopeLock InFlightScopeLock(&InFlightLock);
+		if (TSharedRef<FUMCP_CancellationToken>* Token = InFlightRequests.Find(Key))
+		{
+			(*Token)->Cancel();
+			UE_LOG(LogUnrealMCPServer, Log, TEXT("Cancelled request %s: %s"), *CancelledId.ToString(), *Reason);
+			return true;
+		}
+	}
+	// Already answered, or never seen; either way there is nothing left to stop
+	UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Ignored cancellation of request %s, it is not in flight."), *CancelledId.ToString());
+	return true;
+}
+
 bool FUMCP_Server::Rpc_ToolsList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 {
 	FUMCP_ListToolsParams Params;
-	if (!UMCP_CreateFromJsonObject(Request.params, Params, true))
+	if (!UMCP_CreateFromJsonObject(Request.GetParams(), Params, true))
 	{
 		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
 		OutError.message = TEXT("Failed to parse list tools params");
@@ -298,6 +1103,7 @@ bool FUMCP_Server::Rpc_ToolsList(const FUMCP_JsonRpcRequest& Request, TSharedPtr
 	// a schema that was too complicated to deal with the complexity in the middle.
 	// So for now we manually add them to the response array here.
 	TArray<TSharedPtr<FJsonValue>> ResultTools;
+	FReadScopeLock ReadLock(RegistryLock);
 	for (auto Itr = Tools.CreateConstIterator(); Itr; ++Itr)
 	{
 		auto ToolDef = MakeShared<FJsonObject>();
@@ -311,40 +1117,67 @@ bool FUMCP_Server::Rpc_ToolsList(const FUMCP_JsonRpcRequest& Request, TSharedPtr
 	return true;
 }
 
-bool FUMCP_Server::Rpc_ToolsCall(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+void FUMCP_Server::Rpc_ToolsCall(const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete)
 {
 	FUMCP_CallToolParams Params;
-	UMCP_CreateFromJsonObject(Request.params, Params);
-	auto* Tool = Tools.Find(Params.name);
-	if (!Tool)
+	UMCP_CreateFromJsonObject(Request.GetParams(), Params);
+	FUMCP_ToolCall DoToolCall;
+	FUMCP_ToolCallAsync DoToolCallAsync;
 	{
-		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
-		OutError.message = TEXT("Unknown tool name");
-		return false;
+		FReadScopeLock ReadLock(RegistryLock);
+		auto* Tool = Tools.Find(Params.name);
+		if (!Tool)
+		{
+			OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InvalidParams, TEXT("Unknown tool name")));
+			return;
+		}
+		DoToolCall = Tool->DoToolCall;
+		DoToolCallAsync = Tool->DoToolCallAsync;
 	}
 
-	if (!Tool->DoToolCall.IsBound())
+	if (!DoToolCall.IsBound() && !DoToolCallAsync.IsBound())
 	{
-		OutError.SetError(EUMCP_JsonRpcErrorCode::InternalError);
-		OutError.message = TEXT("Tool has no bound delegate");
-		return false;
+		OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InternalError, TEXT("Tool has no bound delegate")));
+		return;
 	}
 
-	FUMCP_CallToolResult Result;
-	Result.isError = !Tool->DoToolCall.Execute(Params.arguments, Result.content);
-	if (!UMCP_ToJsonObject(Result, OutSuccess))
+	auto FinishToolCall = [OnComplete = MoveTemp(OnComplete), ToolMetrics = Metrics, ToolName = Params.name, StartTime = FPlatformTime::Seconds()](bool bSuccess, TArray<FUMCP_CallToolResultContent>&& Content)
 	{
-		OutError.SetError(EUMCP_JsonRpcErrorCode::InternalError);
-		OutError.message = TEXT("Failed to serialize result");
-		return false;
+		ToolMetrics->RecordToolCall(ToolName, FPlatformTime::Seconds() - StartTime, !bSuccess);
+		FUMCP_CallToolResult Result;
+		Result.isError = !bSuccess;
+		Result.content = MoveTemp(Content);
+		TSharedPtr<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		if (!UMCP_ToJsonObject(Result, ResultObject))
+		{
+			OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InternalError, TEXT("Failed to serialize result")));
+			return;
+		}
+		OnComplete(ResultObject, nullptr);
+	};
+
+	if (DoToolCallAsync.IsBound())
+	{
+		TSharedPtr<FUMCP_RequestContext> SharedContext;
+		TSharedPtr<const FUMCP_CancellationToken> CancellationToken;
+		if (FUMCP_RequestContext* Context = FUMCP_RequestContext::GetCurrent())
+		{
+			SharedContext = Context->AsShared();
+			CancellationToken = Context->GetCancellationToken();
+		}
+		DoToolCallAsync.Execute(Params.arguments, MakeShared<FUMCP_ToolCallCompletion>(MoveTemp(FinishToolCall), MoveTemp(SharedContext), MoveTemp(CancellationToken)));
+		return;
 	}
-	return true;
+
+	TArray<FUMCP_CallToolResultContent> Content;
+	const bool bSuccess = DoToolCall.Execute(Params.arguments, Content);
+	FinishToolCall(bSuccess, MoveTemp(Content));
 }
 
 bool FUMCP_Server::Rpc_ResourcesList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 {
 	FUMCP_ListResourcesParams Params;
-	if (!UMCP_CreateFromJsonObject(Request.params, Params, true))
+	if (!UMCP_CreateFromJsonObject(Request.GetParams(), Params, true))
 	{
 		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
 		OutError.message = TEXT("Failed to parse list resources params");
@@ -352,9 +1185,12 @@ bool FUMCP_Server::Rpc_ResourcesList(const FUMCP_JsonRpcRequest& Request, TShare
 	}
 
 	FUMCP_ListResourcesResult Result;
-	for (auto Itr = Resources.CreateConstIterator(); Itr; ++Itr)
 	{
-		Result.resources.Add(Itr->Value);
+		FReadScopeLock ReadLock(RegistryLock);
+		for (auto Itr = Resources.CreateConstIterator(); Itr; ++Itr)
+		{
+			Result.resources.Add(Itr->Value);
+		}
 	}
 	
 	if (!UMCP_ToJsonObject(Result, OutSuccess))
@@ -369,7 +1205,7 @@ bool FUMCP_Server::Rpc_ResourcesList(const FUMCP_JsonRpcRequest& Request, TShare
 bool FUMCP_Server::Rpc_ResourcesTemplatesList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
 {
 	FUMCP_ListResourceTemplatesParams Params;
-	if (!UMCP_CreateFromJsonObject(Request.params, Params, true))
+	if (!UMCP_CreateFromJsonObject(Request.GetParams(), Params, true))
 	{
 		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
 		OutError.message = TEXT("Failed to parse list resources params");
@@ -377,9 +1213,12 @@ bool FUMCP_Server::Rpc_ResourcesTemplatesList(const FUMCP_JsonRpcRequest& Reques
 	}
 
 	FUMCP_ListResourceTemplatesResult Result;
-	for (auto Itr = ResourceTemplates.CreateConstIterator(); Itr; Itr++)
 	{
-		Result.resourceTemplates.Emplace(Itr->Value);
+		FReadScopeLock ReadLock(RegistryLock);
+		for (auto Itr = ResourceTemplates.CreateConstIterator(); Itr; Itr++)
+		{
+			Result.resourceTemplates.Emplace(Itr->Value);
+		}
 	}
 	if (!UMCP_ToJsonObject(Result, OutSuccess))
 	{
@@ -390,71 +1229,112 @@ bool FUMCP_Server::Rpc_ResourcesTemplatesList(const FUMCP_JsonRpcRequest& Reques
 	return true;
 }
 
-bool FUMCP_Server::Rpc_ResourcesRead(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)
+void FUMCP_Server::Rpc_ResourcesRead(const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete)
 {
 	FUMCP_ReadResourceParams Params;
-	if (!UMCP_CreateFromJsonObject(Request.params, Params))
+	if (!UMCP_CreateFromJsonObject(Request.GetParams(), Params))
 	{
-		OutError.SetError(EUMCP_JsonRpcErrorCode::InvalidParams);
-		OutError.message = TEXT("Failed to parse read resource params");
-        return false;
+		OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InvalidParams, TEXT("Failed to parse read resource params")));
+		return;
 	}
 
-	FUMCP_ReadResourceResult Result;
-
-	// First check our static resources (since the check is easier)
-	auto* Resource = Resources.Find(Params.uri);
-	if (Resource && Resource->ReadResource.IsBound())
+	// Resolve the handler under the registry lock, but run it outside of it
+	FUMCP_ResourceRead ReadResource;
+	FUMCP_ResourceReadAsync ReadResourceAsync;
+	FUMCP_ResourceTemplateRead ReadResourceTemplate;
+	FUMCP_ResourceTemplateReadAsync ReadResourceTemplateAsync;
+	FUMCP_UriTemplate MatchedUriTemplate;
+	FUMCP_UriTemplateMatch Match;
+	bool bFound = false;
 	{
-		if (!Resource->ReadResource.Execute(Params.uri, Result.contents))
+		FReadScopeLock ReadLock(RegistryLock);
+
+		// First check our static resources (since the check is easier)
+		auto* Resource = Resources.Find(Params.uri);
+		if (Resource && Resource->IsBound())
 		{
-			OutError.SetError(EUMCP_JsonRpcErrorCode::ResourceNotFound);
-			OutError.message = TEXT("Failed to load resource contents");
-			return false;
+			ReadResource = Resource->ReadResource;
+			ReadResourceAsync = Resource->ReadResourceAsync;
+			bFound = true;
 		}
-		
-		if (!UMCP_ToJsonObject(Result, OutSuccess))
+		else
 		{
-			OutError.SetError(EUMCP_JsonRpcErrorCode::InternalError);
-			OutError.message = TEXT("Failed to serialize result");
-			return false;
+			// Check resouce templates
+			for (auto Itr = ResourceTemplates.CreateConstIterator(); Itr; ++Itr)
+			{
+				auto& ResourceTemplate = Itr->Value;
+				if (!ResourceTemplate.IsBound())
+				{
+					continue;
+				}
+				
+				auto& UriTemplate = Itr->Key;
+				Match = FUMCP_UriTemplateMatch();
+				if (!UriTemplate.FindMatch(Params.uri, Match))
+				{
+					continue;
+				}
+
+				MatchedUriTemplate = UriTemplate;
+				ReadResourceTemplate = ResourceTemplate.ReadResource;
+				ReadResourceTemplateAsync = ResourceTemplate.ReadResourceAsync;
+				bFound = true;
+				break;
+			}
 		}
-		return true;
 	}
 
-	// Check resouce templates
-	for (auto Itr = ResourceTemplates.CreateConstIterator(); Itr; ++Itr)
+	if (!bFound)
+	{
+		OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::ResourceNotFound, TEXT("Resource not found")));
+		return;
+	}
+
+	// Static resources that fail to read are reported as missing, templated ones as an internal error
+	const bool bIsTemplate = ReadResourceTemplate.IsBound() || ReadResourceTemplateAsync.IsBound();
+	auto FinishRead = [OnComplete = MoveTemp(OnComplete), bIsTemplate](bool bSuccess, TArray<FUMCP_ReadResourceResultContent>&& Contents)
 	{
-		auto& ResourceTemplate = Itr->Value;
-		if (!ResourceTemplate.ReadResource.IsBound())
+		if (!bSuccess)
 		{
-			continue;
+			OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(bIsTemplate ? EUMCP_JsonRpcErrorCode::InternalError : EUMCP_JsonRpcErrorCode::ResourceNotFound, TEXT("Failed to load resource contents")));
+			return;
 		}
-		
-		auto& UriTemplate = Itr->Key;
-		FUMCP_UriTemplateMatch Match;
-		if (!UriTemplate.FindMatch(Params.uri, Match))
+
+		FUMCP_ReadResourceResult Result;
+		Result.contents = MoveTemp(Contents);
+		TSharedPtr<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		if (!UMCP_ToJsonObject(Result, ResultObject))
 		{
-			continue;
+			OnComplete(nullptr, MakeShared<FUMCP_JsonRpcError>(EUMCP_JsonRpcErrorCode::InternalError, TEXT("Failed to serialize result")));
+			return;
 		}
+		OnComplete(ResultObject, nullptr);
+	};
 
-		if (!ResourceTemplate.ReadResource.Execute(UriTemplate, Match, Result.contents))
+	if (ReadResourceAsync.IsBound() || ReadResourceTemplateAsync.IsBound())
+	{
+		TSharedPtr<FUMCP_RequestContext> SharedContext;
+		TSharedPtr<const FUMCP_CancellationToken> CancellationToken;
+		if (FUMCP_RequestContext* Context = FUMCP_RequestContext::GetCurrent())
 		{
-			OutError.SetError(EUMCP_JsonRpcErrorCode::InternalError);
-			OutError.message = TEXT("Failed to load resource contents");
-			return false;
+			SharedContext = Context->AsShared();
+			CancellationToken = Context->GetCancellationToken();
 		}
-		
-		if (!UMCP_ToJsonObject(Result, OutSuccess))
+		TSharedRef<FUMCP_ResourceReadCompletion> Completion = MakeShared<FUMCP_ResourceReadCompletion>(MoveTemp(FinishRead), MoveTemp(SharedContext), MoveTemp(CancellationToken));
+		if (ReadResourceAsync.IsBound())
 		{
-			OutError.SetError(EUMCP_JsonRpcErrorCode::InternalError);
-			OutError.message = TEXT("Failed to serialize result");
-			return false;
+			ReadResourceAsync.Execute(Params.uri, Completion);
 		}
-		return true;
+		else
+		{
+			ReadResourceTemplateAsync.Execute(MatchedUriTemplate, Match, Completion);
+		}
+		return;
 	}
-	
-	OutError.SetError(EUMCP_JsonRpcErrorCode::ResourceNotFound);
-	OutError.message = TEXT("Resource not found");
-	return false;
+
+	TArray<FUMCP_ReadResourceResultContent> Contents;
+	const bool bSuccess = ReadResource.IsBound()
+		? ReadResource.Execute(Params.uri, Contents)
+		: ReadResourceTemplate.Execute(MatchedUriTemplate, Match, Contents);
+	FinishRead(bSuccess, MoveTemp(Contents));
 }
@@ -0,0 +1,115 @@
+#include "UMCP_StreamedText.h"
+#include "UMCP_RequestContext.h"
+#include "UMCP_Scheduler.h"
+#include "UnrealMCPServerModule.h"
+
+namespace
+{
+	// Matches how long an event stream waits for a poll before it is dropped
+	constexpr double StalledStreamSeconds = 60.0;
+}
+
+void FUMCP_StreamedText::Start(FString&& InText, int32 InChunkChars, int64 InMaxPendingBytes, TArray<FUMCP_CallToolResultContent>&& InFinalContent,
+	const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FUMCP_StreamedText> Stream = MakeShared<FUMCP_StreamedText>(MoveTemp(InText), InChunkChars, InMaxPendingBytes, MoveTemp(InFinalContent), InScheduler, InCompletion);
+	Stream->SendChunks();
+}
+
+FUMCP_StreamedText::FUMCP_StreamedText(FString&& InText, int32 InChunkChars, int64 InMaxPendingBytes, TArray<FUMCP_CallToolResultContent>&& InFinalContent,
+	const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion)
+	: Text(MoveTemp(InText))
+	, ChunkChars(FMath::Max(InChunkChars, 2))
+	, MaxPendingBytes(InMaxPendingBytes)
+	, FinalContent(MoveTemp(InFinalContent))
+	, Scheduler(InScheduler)
+	, Completion(InCompletion)
+	, LastProgressTime(FPlatformTime::Seconds())
+{
+}
+
+void FUMCP_StreamedText::SendChunks()
+{
+	if (Completion->IsCompleted())
+	{
+		return;
+	}
+	const TSharedPtr<FUMCP_RequestContext>& Context = Completion->GetContext();
+	if (Completion->IsCancelled() || !Context.IsValid())
+	{
+		Completion->Complete(false, TArray<FUMCP_CallToolResultContent>());
+		return;
+	}
+
+	// Once the client has picked up everything, a chunk goes out whatever the limit, so a limit below the chunk size still makes progress
+	int64 PendingBytes = Context->GetPendingStreamBytes();
+	bool bSentAny = false;
+	while (Offset < Text.Len() && (PendingBytes < MaxPendingBytes || PendingBytes == 0))
+	{
+		int32 NumChars = FMath::Min(ChunkChars, Text.Len() - Offset);
+		// A surrogate pair stays together in the next chunk
+		if (Offset + NumChars < Text.Len() && StringConv::IsHighSurrogate(Text[Offset + NumChars - 1]))
+		{
+			--NumChars;
+		}
+		TArray<FUMCP_CallToolResultContent> PartialContent;
+		FUMCP_CallToolResultContent& ChunkContent = PartialContent.AddDefaulted_GetRef();
+		ChunkContent.type = TEXT("text");
+		ChunkContent.text = FString(FStringView(Text).Mid(Offset, NumChars));
+		Context->SendPartialContent(PartialContent);
+		Offset += NumChars;
+		bSentAny = true;
+		PendingBytes = Context->GetPendingStreamBytes();
+	}
+
+	if (Offset >= Text.Len())
+	{
+		Completion->Complete(true, MoveTemp(FinalContent));
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (bSentAny || PendingBytes < LastPendingBytes)
+	{
+		LastProgressTime = Now;
+	}
+	LastPendingBytes = PendingBytes;
+	if (Now - LastProgressTime > StalledStreamSeconds)
+	{
+		UE_LOG(LogUnrealMCPServer, Warning, TEXT("StreamedText: Gave up after %.0f seconds without the client reading, %d of %d characters sent."), StalledStreamSeconds, Offset, Text.Len());
+		Fail(TEXT("The client stopped reading the stream."));
+		return;
+	}
+	Queue();
+}
+
+void FUMCP_StreamedText::Queue()
+{
+	TSharedPtr<FUMCP_GameThreadScheduler> PinnedScheduler = Scheduler.Pin();
+	if (!PinnedScheduler.IsValid())
+	{
+		Fail(TEXT("Server is shutting down"));
+		return;
+	}
+	const TSharedPtr<FUMCP_RequestContext>& Context = Completion->GetContext();
+	// Runs again on the next frame, by then the client may have picked up what is pending
+	PinnedScheduler->Enqueue(Context->GetSessionKey(), EUMCP_RequestPriority::Low, [Stream = AsShared()]()
+	{
+		Stream->SendChunks();
+	},
+	[Stream = AsShared()]()
+	{
+		Stream->Fail(TEXT("Server is shutting down"));
+	});
+}
+
+void FUMCP_StreamedText::Fail(const FString& Message)
+{
+	TArray<FUMCP_CallToolResultContent> Content;
+	FUMCP_CallToolResultContent& Error = Content.AddDefaulted_GetRef();
+	Error.type = TEXT("text");
+	Error.text = Message;
+	Completion->Complete(false, MoveTemp(Content));
+}
@@ -0,0 +1,268 @@
+#include "UMCP_T3DExportCache.h"
+#include "UMCP_TextDiff.h"
+#include "UnrealMCPServerModule.h"
+
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Blueprint.h"
+#include "Exporters/Exporter.h"
+#include "Hash/xxhash.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarT3DExportCacheMaxMB(
+		TEXT("UMCP.T3DExportCache.MaxMB"),
+		64,
+		TEXT("Memory the cached T3D exports of Blueprints may take up, 0 disables the cache."));
+
+	int64 GetMaxBytes()
+	{
+		return static_cast<int64>(CVarT3DExportCacheMaxMB.GetValueOnGameThread()) * 1024 * 1024;
+	}
+
+	// Enough to diff against what a client read a few edits ago
+	constexpr int32 MaxVersionsPerBlueprint = 4;
+
+	int64 GetTextBytes(const FString& Text)
+	{
+		return static_cast<int64>(Text.Len()) * sizeof(TCHAR);
+	}
+
+	uint64 HashText(const FString& Text)
+	{
+		return FXxHash64::HashBuffer(*Text, Text.Len() * sizeof(TCHAR)).Hash;
+	}
+
+	FString MakeVersionTag(uint64 Hash)
+	{
+		return FString::Printf(TEXT("%016llx"), Hash);
+	}
+
+	bool ExportUncached(const FString& BlueprintPath, FStringOutputDevice& Output, FString& OutError)
+	{
+		UBlueprint* Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
+		if (!Blueprint)
+		{
+			OutError = FString::Printf(TEXT("Failed to load Blueprint: %s"), *BlueprintPath);
+			return false;
+		}
+
+		UExporter* Exporter = UExporter::FindExporter(Blueprint, TEXT("T3D"));
+		if (!Exporter)
+		{
+			OutError = FString::Printf(TEXT("Failed to find T3D exporter for Blueprint: %s"), *BlueprintPath);
+			return false;
+		}
+
+		const uint32 ExportFlags = PPF_Copy | PPF_ExportsNotFullyQualified;
+		UE_LOG(LogUnrealMCPServer, Log, TEXT("Attempting to export Blueprint '%s' to T3D format using exporter: %s"), *BlueprintPath, *Exporter->GetClass()->GetName());
+		Exporter->ExportText(nullptr, Blueprint, TEXT("T3D"), Output, GWarn, ExportFlags);
+		if (Output.IsEmpty())
+		{
+			OutError = FString::Printf(TEXT("ExportText did not produce any output for Blueprint: %s. Using exporter: %s."), *BlueprintPath, *Exporter->GetClass()->GetName());
+			UE_LOG(LogUnrealMCPServer, Warning, TEXT("%s"), *OutError);
+			return false;
+		}
+		return true;
+	}
+}
+
+FString FUMCP_T3DExportCache::FVersionedExport::GetInfoJson() const
+{
+	const TCHAR* StatusName = Status == EExportStatus::NotModified ? TEXT("notModified") : Status == EExportStatus::Diff ? TEXT("diff") : TEXT("full");
+	FString Json = FString::Printf(TEXT("{\"version\":\"%s\",\"status\":\"%s\""), *Version, StatusName);
+	if (!BaseVersion.IsEmpty())
+	{
+		Json += FString::Printf(TEXT(",\"baseVersion\":\"%s\""), *BaseVersion);
+	}
+	return Json + TEXT("}");
+}
+
+bool FUMCP_T3DExportCache::Export(const FString& BlueprintPath, FString& OutText, FString* OutVersion)
+{
+	FIoHash SavedHash;
+	bool bCacheable = false;
+	if (const FVersion* Current = FindCurrent(BlueprintPath, SavedHash, bCacheable))
+	{
+		OutText = Current->Text;
+		if (OutVersion)
+		{
+			*OutVersion = MakeVersionTag(Current->Hash);
+		}
+		return true;
+	}
+
+	FStringOutputDevice Output;
+	if (!ExportUncached(BlueprintPath, Output, OutText))
+	{
+		return false;
+	}
+	OutText = MoveTemp(Output);
+
+	// Kept even when it can't become current, as the base of a later diff
+	const uint64 Hash = HashText(OutText);
+	AddVersion(BlueprintPath, bCacheable ? SavedHash : FIoHash(), Hash, OutText);
+	if (OutVersion)
+	{
+		*OutVersion = MakeVersionTag(Hash);
+	}
+	return true;
+}
+
+bool FUMCP_T3DExportCache::ExportSince(const FString& BlueprintPath, const FString& KnownVersion, FVersionedExport& OutExport, FString& OutError)
+{
+	OutExport = FVersionedExport();
+	if (!Export(BlueprintPath, OutExport.Text, &OutExport.Version))
+	{
+		OutError = MoveTemp(OutExport.Text);
+		return false;
+	}
+	if (KnownVersion.IsEmpty())
+	{
+		return true;
+	}
+
+	if (KnownVersion == OutExport.Version)
+	{
+		OutExport.Status = EExportStatus::NotModified;
+		OutExport.Text.Reset();
+		return true;
+	}
+	if (const FVersion* Base = FindVersion(BlueprintPath, KnownVersion))
+	{
+		FString Diff;
+		if (FUMCP_TextDiff::MakeUnifiedDiff(Base->Text, OutExport.Text, Diff) && Diff.Len() < OutExport.Text.Len())
+		{
+			UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Sending a diff of %d characters for the T3D export of '%s' instead of %d."), Diff.Len(), *BlueprintPath, OutExport.Text.Len());
+			OutExport.Status = EExportStatus::Diff;
+			OutExport.BaseVersion = KnownVersion;
+			OutExport.Text = MoveTemp(Diff);
+		}
+	}
+	return true;
+}
+
+FUMCP_T3DExportCache::FVersion* FUMCP_T3DExportCache::FindCurrent(const FString& BlueprintPath, FIoHash& OutSavedHash, bool& bOutCacheable)
+{
+	check(IsInGameThread());
+
+	const FString PackageName = FPackageName::ObjectPathToPackageName(BlueprintPath);
+	OutSavedHash = FIoHash();
+	if (TOptional<FAssetPackageData> PackageData = IAssetRegistry::GetChecked().GetAssetPackageDataCopy(FName(*PackageName)))
+	{
+		OutSavedHash = PackageData->GetPackageSavedHash();
+	}
+	// The saved hash says nothing about edits that aren't saved yet
+	const UPackage* LoadedPackage = FindPackage(nullptr, *PackageName);
+	bOutCacheable = GetMaxBytes() > 0 && !OutSavedHash.IsZero() && !(LoadedPackage && LoadedPackage->IsDirty());
+
+	FEntry* Entry = Entries.Find(BlueprintPath);
+	if (!bOutCacheable || !Entry || Entry->SavedHash != OutSavedHash || Entry->Versions.IsEmpty())
+	{
+		return nullptr;
+	}
+	UE_LOG(LogUnrealMCPServer, Verbose, TEXT("Serving the T3D export of '%s' from the cache."), *BlueprintPath);
+	FVersion& Current = Entry->Versions.Last();
+	Current.LastUse = ++UseCounter;
+	return &Current;
+}
+
+FUMCP_T3DExportCache::FVersion* FUMCP_T3DExportCache::FindVersion(const FString& BlueprintPath, const FString& Version)
+{
+	FEntry* Entry = Entries.Find(BlueprintPath);
+	if (!Entry)
+	{
+		return nullptr;
+	}
+	for (FVersion& Candidate : Entry->Versions)
+	{
+		if (MakeVersionTag(Candidate.Hash) == Version)
+		{
+			Candidate.LastUse = ++UseCounter;
+			return &Candidate;
+		}
+	}
+	return nullptr;
+}
+
+void FUMCP_T3DExportCache::AddVersion(const FString& BlueprintPath, const FIoHash& SavedHash, uint64 Hash, const FString& Text)
+{
+	// Whatever was current before isn't any more
+	if (FEntry* Entry = Entries.Find(BlueprintPath))
+	{
+		Entry->SavedHash = FIoHash();
+		// The same text exported again moves to the end rather than being kept twice
+		const int32 SameIndex = Entry->Versions.IndexOfByPredicate([Hash](const FVersion& Version) { return Version.Hash == Hash; });
+		if (SameIndex != INDEX_NONE)
+		{
+			TotalBytes -= GetTextBytes(Entry->Versions[SameIndex].Text);
+			Entry->Versions.RemoveAt(SameIndex);
+		}
+		if (Entry->Versions.Num() >= MaxVersionsPerBlueprint)
+		{
+			TotalBytes -= GetTextBytes(Entry->Versions[0].Text);
+			Entry->Versions.RemoveAt(0);
+		}
+		if (Entry->Versions.IsEmpty())
+		{
+			Entries.Remove(BlueprintPath);
+		}
+	}
+
+	const int64 MaxBytes = GetMaxBytes();
+	const int64 VersionBytes = GetTextBytes(Text);
+	if (VersionBytes > MaxBytes)
+	{
+		return;
+	}
+	Trim(MaxBytes - VersionBytes);
+	FEntry& Entry = Entries.FindOrAdd(BlueprintPath);
+	Entry.SavedHash = SavedHash;
+	FVersion& Version = Entry.Versions.AddDefaulted_GetRef();
+	Version.Hash = Hash;
+	Version.Text = Text;
+	Version.LastUse = ++UseCounter;
+	TotalBytes += VersionBytes;
+}
+
+void FUMCP_T3DExportCache::Trim(int64 MaxBytes)
+{
+	// Few enough versions fit in the budget that a scan for the oldest is cheap
+	while (TotalBytes > MaxBytes && Entries.Num() > 0)
+	{
+		FEntry* OldestEntry = nullptr;
+		const FString* OldestPath = nullptr;
+		int32 OldestIndex = INDEX_NONE;
+		for (TPair<FString, FEntry>& Entry : Entries)
+		{
+			for (int32 Index = 0; Index < Entry.Value.Versions.Num(); ++Index)
+			{
+				if (!OldestEntry || Entry.Value.Versions[Index].LastUse < OldestEntry->Versions[OldestIndex].LastUse)
+				{
+					OldestEntry = &Entry.Value;
+					OldestPath = &Entry.Key;
+					OldestIndex = Index;
+				}
+			}
+		}
+		if (!OldestEntry)
+		{
+			break;
+		}
+
+		TotalBytes -= GetTextBytes(OldestEntry->Versions[OldestIndex].Text);
+		if (OldestIndex == OldestEntry->Versions.Num() - 1)
+		{
+			// The newest goes, what is left is older than the package
+			OldestEntry->SavedHash = FIoHash();
+		}
+		OldestEntry->Versions.RemoveAt(OldestIndex);
+		if (OldestEntry->Versions.IsEmpty())
+		{
+			const FString Path = *OldestPath;
+			Entries.Remove(Path);
+		}
+	}
+}
@@ -0,0 +1,180 @@
+#include "UMCP_TextDiff.h"
+
+#include "Algo/Reverse.h"
+#include "Hash/CityHash.h"
+
+namespace
+{
+	struct FLine
+	{
+		// Includes the line break, so a missing one at the end of the text is a difference too
+		FStringView Text;
+		uint64 Hash = 0;
+	};
+
+	enum class EEditOp : uint8
+	{
+		Equal,
+		Delete,
+		Insert,
+	};
+
+	void SplitLines(const FString& Text, TArray<FLine>& OutLines)
+	{
+		int32 LineStart = 0;
+		for (int32 Index = 0; Index <= Text.Len(); ++Index)
+		{
+			if (Index == Text.Len() ? LineStart < Index : Text[Index] == TEXT('\n'))
+			{
+				FLine& Line = OutLines.AddDefaulted_GetRef();
+				Line.Text = FStringView(*Text + LineStart, FMath::Min(Index + 1, Text.Len()) - LineStart);
+				Line.Hash = CityHash64(reinterpret_cast<const char*>(Line.Text.GetData()), Line.Text.Len() * sizeof(TCHAR));
+				LineStart = Index + 1;
+			}
+		}
+	}
+
+	bool LinesEqual(const FLine& A, const FLine& B)
+	{
+		return A.Hash == B.Hash && A.Text.Equals(B.Text, ESearchCase::CaseSensitive);
+	}
+
+	// Shortest edit script from A to B, in order. False when it takes more than MaxEdits.
+	bool FindEdits(TConstArrayView<FLine> A, TConstArrayView<FLine> B, int32 MaxEdits, TArray<EEditOp>& OutOps)
+	{
+		const int32 N = A.Num();
+		const int32 M = B.Num();
+		const int32 MaxD = FMath::Min(N + M, MaxEdits);
+		// Furthest X reached on each diagonal K = X - Y, indexed from -MaxD - 1
+		const int32 Offset = MaxD + 1;
+		TArray<int32> V;
+		V.SetNumZeroed(2 * MaxD + 3);
+		// V as each round found it, over the diagonals -D..D, for walking the path back
+		TArray<TArray<int32>> Trace;
+
+		for (int32 D = 0; D <= MaxD; ++D)
+		{
+			Trace.Emplace(V.GetData() + Offset - D, 2 * D + 1);
+			for (int32 K = -D; K <= D; K += 2)
+			{
+				// Step down (insert) from the diagonal above or right (delete) from the one below, whichever got further
+				int32 X = (K == -D || (K != D && V[Offset + K - 1] < V[Offset + K + 1])) ? V[Offset + K + 1] : V[Offset + K - 1] + 1;
+				int32 Y = X - K;
+				while (X < N && Y < M && LinesEqual(A[X], B[Y]))
+				{
+					++X;
+					++Y;
+				}
+				V[Offset + K] = X;
+				if (X < N || Y < M)
+				{
+					continue;
+				}
+
+				for (int32 Round = D; Round > 0; --Round)
+				{
+					const TArray<int32>& Previous = Trace[Round];
+					const int32 PathK = X - Y;
+					const int32 PreviousK = (PathK == -Round || (PathK != Round && Previous[PathK - 1 + Round] < Previous[PathK + 1 + Round])) ? PathK + 1 : PathK - 1;
+					const int32 PreviousX = Previous[PreviousK + Round];
+					const int32 PreviousY = PreviousX - PreviousK;
+					while (X > PreviousX && Y > PreviousY)
+					{
+						OutOps.Add(EEditOp::Equal);
+						--X;
+						--Y;
+					}
+					OutOps.Add(X == PreviousX ? EEditOp::Insert : EEditOp::Delete);
+					X = PreviousX;
+					Y = PreviousY;
+				}
+				for (; X > 0; --X)
+				{
+					OutOps.Add(EEditOp::Equal);
+				}
+				Algo::Reverse(OutOps);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void AppendLine(FString& Out, TCHAR Prefix, FStringView Line)
+	{
+		Out.AppendChar(Prefix);
+		Out.Append(Line.GetData(), Line.Len());
+		if (!Line.EndsWith(TEXT('\n')))
+		{
+			Out.Append(TEXT("\n\\ No newline at end of file\n"));
+		}
+	}
+}
+
+bool FUMCP_TextDiff::MakeUnifiedDiff(const FString& OldText, const FString& NewText, FString& OutDiff, int32 MaxEdits)
+{
+	OutDiff.Reset();
+	TArray<FLine> OldLines;
+	TArray<FLine> NewLines;
+	SplitLines(OldText, OldLines);
+	SplitLines(NewText, NewLines);
+
+	// Edits tend to be local, the search only needs to cover the part between the common head and tail
+	int32 Head = 0;
+	while (Head < OldLines.Num() && Head < NewLines.Num() && LinesEqual(OldLines[Head], NewLines[Head]))
+	{
+		++Head;
+	}
+	int32 Tail = 0;
+	while (Tail < OldLines.Num() - Head && Tail < NewLines.Num() - Head && LinesEqual(OldLines[OldLines.Num() - 1 - Tail], NewLines[NewLines.Num() - 1 - Tail]))
+	{
+		++Tail;
+	}
+
+	TArray<EEditOp> Ops;
+	const TConstArrayView<FLine> OldMiddle = TConstArrayView<FLine>(OldLines).Slice(Head, OldLines.Num() - Head - Tail);
+	const TConstArrayView<FLine> NewMiddle = TConstArrayView<FLine>(NewLines).Slice(Head, NewLines.Num() - Head - Tail);
+	if (!FindEdits(OldMiddle, NewMiddle, MaxEdits, Ops))
+	{
+		return false;
+	}
+
+	// One hunk per run of edits, deletions before insertions
+	int32 OldIndex = Head;
+	int32 NewIndex = Head;
+	for (int32 OpIndex = 0; OpIndex < Ops.Num();)
+	{
+		if (Ops[OpIndex] == EEditOp::Equal)
+		{
+			++OldIndex;
+			++NewIndex;
+			++OpIndex;
+			continue;
+		}
+		const int32 OldStart = OldIndex;
+		const int32 NewStart = NewIndex;
+		for (; OpIndex < Ops.Num() && Ops[OpIndex] != EEditOp::Equal; ++OpIndex)
+		{
+			if (Ops[OpIndex] == EEditOp::Delete)
+			{
+				++OldIndex;
+			}
+			else
+			{
+				++NewIndex;
+			}
+		}
+		const int32 Deleted = OldIndex - OldStart;
+		const int32 Inserted = NewIndex - NewStart;
+		// An empty range is numbered by the line before it
+		OutDiff.Appendf(TEXT("@@ -%d,%d +%d,%d @@\n"), Deleted > 0 ? OldStart + 1 : OldStart, Deleted, Inserted > 0 ? NewStart + 1 : NewStart, Inserted);
+		for (int32 Line = OldStart; Line < OldIndex; ++Line)
+		{
+			AppendLine(OutDiff, TEXT('-'), OldLines[Line].Text);
+		}
+		for (int32 Line = NewStart; Line < NewIndex; ++Line)
+		{
+			AppendLine(OutDiff, TEXT('+'), NewLines[Line].Text);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,121 @@
+#include "UMCP_TrigramIndex.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+
+namespace
+{
+	uint64 MakeTrigram(TCHAR A, TCHAR B, TCHAR C)
+	{
+		// 21 bits per character covers all of Unicode
+		constexpr uint64 Mask = (1ull << 21) - 1;
+		return ((static_cast<uint64>(A) & Mask) << 42) | ((static_cast<uint64>(B) & Mask) << 21) | (static_cast<uint64>(C) & Mask);
+	}
+}
+
+void FUMCP_TrigramIndex::GetTrigrams(FStringView Text, TArray<uint64>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+	for (int32 Index = 0; Index + MinTermLength <= Text.Len(); ++Index)
+	{
+		OutTrigrams.Add(MakeTrigram(Text[Index], Text[Index + 1], Text[Index + 2]));
+	}
+	// A repeated trigram only needs the id posted once
+	Algo::Sort(OutTrigrams);
+	OutTrigrams.SetNum(Algo::Unique(OutTrigrams));
+}
+
+void FUMCP_TrigramIndex::Add(int32 Id, FStringView Text)
+{
+	TArray<uint64> Trigrams;
+	GetTrigrams(Text, Trigrams);
+	for (uint64 Trigram : Trigrams)
+	{
+		TArray<int32>& Ids = Postings.FindOrAdd(Trigram);
+		// Ids mostly arrive in increasing order, only reused ids need the search
+		if (Ids.IsEmpty() || Ids.Last() < Id)
+		{
+			Ids.Add(Id);
+			continue;
+		}
+		const int32 Position = Algo::LowerBound(Ids, Id);
+		if (Ids[Position] != Id)
+		{
+			Ids.Insert(Id, Position);
+		}
+	}
+}
+
+void FUMCP_TrigramIndex::Remove(int32 Id, FStringView Text)
+{
+	TArray<uint64> Trigrams;
+	GetTrigrams(Text, Trigrams);
+	for (uint64 Trigram : Trigrams)
+	{
+		TArray<int32>* Ids = Postings.Find(Trigram);
+		if (!Ids)
+		{
+			continue;
+		}
+		const int32 Position = Algo::BinarySearch(*Ids, Id);
+		if (Position != INDEX_NONE)
+		{
+			Ids->RemoveAt(Position);
+		}
+		if (Ids->IsEmpty())
+		{
+			Postings.Remove(Trigram);
+		}
+	}
+}
+
+bool FUMCP_TrigramIndex::FindCandidates(FStringView Term, TArray<int32>& OutIds) const
+{
+	OutIds.Reset();
+	if (Term.Len() < MinTermLength)
+	{
+		return false;
+	}
+
+	TArray<uint64> Trigrams;
+	GetTrigrams(Term, Trigrams);
+	TArray<const TArray<int32>*, TInlineAllocator<16>> Lists;
+	for (uint64 Trigram : Trigrams)
+	{
+		const TArray<int32>* Ids = Postings.Find(Trigram);
+		if (!Ids)
+		{
+			// Nothing contains this trigram, so nothing contains the term
+			return true;
+		}
+		Lists.Add(Ids);
+	}
+
+	// Start from the rarest trigram, the candidates only shrink from there
+	Lists.Sort([](const TArray<int32>& A, const TArray<int32>& B) { return A.Num() < B.Num(); });
+	OutIds = *Lists[0];
+	for (int32 ListIndex = 1; ListIndex < Lists.Num() && !OutIds.IsEmpty(); ++ListIndex)
+	{
+		const TArray<int32>& Other = *Lists[ListIndex];
+		int32 Kept = 0;
+		int32 OtherIndex = 0;
+		for (int32 Id : OutIds)
+		{
+			while (OtherIndex < Other.Num() && Other[OtherIndex] < Id)
+			{
+				++OtherIndex;
+			}
+			if (OtherIndex == Other.Num())
+			{
+				break;
+			}
+			if (Other[OtherIndex] == Id)
+			{
+				OutIds[Kept++] = Id;
+			}
+		}
+		OutIds.SetNum(Kept);
+	}
+	return true;
+}
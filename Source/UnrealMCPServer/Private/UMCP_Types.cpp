@@ -18,6 +18,7 @@ FUMCP_JsonRpcId FUMCP_JsonRpcId::CreateFromJsonValue(const TSharedPtr<FJsonValue
 bool FUMCP_JsonRpcId::IsString() const { return Value.IsValid() && Value->Type == EJson::String; }
 bool FUMCP_JsonRpcId::IsNumber() const { return Value.IsValid() && Value->Type == EJson::Number; }
 bool FUMCP_JsonRpcId::IsNull() const { return !Value.IsValid() || Value->Type == EJson::Null; }
+bool FUMCP_JsonRpcId::IsAbsent() const { return !Value.IsValid(); }
 
 TSharedPtr<FJsonValue> FUMCP_JsonRpcId::GetJsonValue() const 
 {
@@ -37,20 +38,47 @@ FString FUMCP_JsonRpcId::ToString() const
 	switch (Value->Type)
 	{
 		case EJson::String: return Value->AsString();
-		case EJson::Number: return FString::Printf(TEXT("%g"), Value->AsNumber());
+		case EJson::Number:
+		{
+			// Exact for integral ids, which is nearly all of them, %g would round ids past six digits together
+			const double Number = Value->AsNumber();
+			if (FMath::Abs(Number) < 9.2e18 && FMath::TruncToDouble(Number) == Number)
+			{
+				return FString::Printf(TEXT("%lld"), static_cast<int64>(Number));
+			}
+			return FString::Printf(TEXT("%.17g"), Number);
+		}
 		case EJson::Null:   return TEXT("[null]");
 		default: // Should not happen for a valid ID (boolean, array, object)
 			return TEXT("[invalid_id_type]"); 
 	}
 }
+TSharedPtr<FJsonObject> FUMCP_JsonRpcRequest::GetParams() const
+{
+	if (!params.IsValid() && paramsView.IsSet())
+	{
+		params = paramsView.ParseObject();
+	}
+	return params;
+}
+
+bool FUMCP_JsonRpcRequest::TryGetParamsStringField(const FString& FieldName, FString& OutValue) const
+{
+	if (params.IsValid())
+	{
+		return params->TryGetStringField(FieldName, OutValue);
+	}
+	return paramsView.IsSet() && paramsView.TryGetStringField(FieldName, OutValue);
+}
+
 bool FUMCP_JsonRpcRequest::ToJsonString(FString& OutJsonString) const
 {
 	TSharedPtr<FJsonObject> JsonObject = MakeShared<FJsonObject>();
 	JsonObject->SetStringField(TEXT("jsonrpc"), jsonrpc);
 	JsonObject->SetStringField(TEXT("method"), method);
-	if (params.IsValid())
+	if (TSharedPtr<FJsonObject> ParamsObject = GetParams())
 	{
-		JsonObject->SetObjectField(TEXT("params"), params);
+		JsonObject->SetObjectField(TEXT("params"), ParamsObject);
 	}
 	
 	// Use id.GetJsonValue() which can be nullptr if ID is absent
@@ -75,23 +103,37 @@ bool FUMCP_JsonRpcRequest::CreateFromJsonString(const FString& JsonString, FUMCP
 		return false;
 	}
 
+	if (!CreateFromJsonObject(RootJsonObject, OutRequest))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FJsonRpcRequest::CreateFromJsonString: Missing 'jsonrpc' or 'method'. String: %s"), *JsonString);
+		return false;
+	}
+	return true;
+}
+
+bool FUMCP_JsonRpcRequest::CreateFromJsonObject(const TSharedPtr<FJsonObject>& RootJsonObject, FUMCP_JsonRpcRequest& OutRequest)
+{
+	if (!RootJsonObject.IsValid())
+	{
+		return false;
+	}
+
 	if (!RootJsonObject->TryGetStringField(TEXT("jsonrpc"), OutRequest.jsonrpc) ||
 		!RootJsonObject->TryGetStringField(TEXT("method"), OutRequest.method))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FJsonRpcRequest::CreateFromJsonString: Missing 'jsonrpc' or 'method'. String: %s"), *JsonString);
 		return false;
 	}
 
 	// Get the "id" field as an FJsonValue if it exists, then create FJsonRpcId from it.
-	// If "id" field is not present in JSON, GetField returns nullptr, 
-	// and CreateFromJsonValue correctly creates an 'absent' FJsonRpcId.
+	// If "id" field is not present in JSON the request is a notification, so the id is left 'absent'
+	// (an explicit `"id": null` still produces a 'null' ID).
 	if (RootJsonObject->HasField(TEXT("id")))
 	{
 		OutRequest.id = FUMCP_JsonRpcId::CreateFromJsonValue(RootJsonObject->GetField<EJson::None>(TEXT("id")));
 	}
 	else
 	{
-		OutRequest.id = FUMCP_JsonRpcId::CreateNullId();
+		OutRequest.id = FUMCP_JsonRpcId();
 	}
 	
 	if (RootJsonObject->HasTypedField<EJson::Object>(TEXT("params")))
@@ -105,9 +147,58 @@ bool FUMCP_JsonRpcRequest::CreateFromJsonString(const FString& JsonString, FUMCP
 		// the subsequent check 'RpcRequest.params.IsValid()' will correctly fail for it.
 		OutRequest.params = nullptr; 
 	}
+	OutRequest.paramsView = FUMCP_JsonUtf8View();
 
 	return true;
 }
+
+bool FUMCP_JsonRpcRequest::CreateFromJsonUtf8(const FUMCP_JsonUtf8View& JsonView, FUMCP_JsonRpcRequest& OutRequest)
+{
+	FUMCP_JsonUtf8Reader Reader(JsonView.GetBytes());
+	if (!Reader.BeginObject())
+	{
+		return false;
+	}
+
+	bool bHasJsonRpc = false;
+	bool bHasMethod = false;
+	OutRequest.id = FUMCP_JsonRpcId();
+	OutRequest.params = nullptr;
+	OutRequest.paramsView = FUMCP_JsonUtf8View();
+
+	FString Key;
+	while (Reader.NextMember(Key))
+	{
+		if (Key == TEXT("jsonrpc") && Reader.Peek() == '"')
+		{
+			bHasJsonRpc = Reader.ReadString(OutRequest.jsonrpc);
+		}
+		else if (Key == TEXT("method") && Reader.Peek() == '"')
+		{
+			bHasMethod = Reader.ReadString(OutRequest.method);
+		}
+		else if (Key == TEXT("id"))
+		{
+			// Ids are tiny, so building a value for them costs next to nothing
+			OutRequest.id = FUMCP_JsonRpcId::CreateFromJsonValue(Reader.ReadValue());
+		}
+		else if (Key == TEXT("params") && Reader.Peek() == '{')
+		{
+			const int32 Start = Reader.GetPosition();
+			if (!Reader.SkipValue())
+			{
+				return false;
+			}
+			OutRequest.paramsView = FUMCP_JsonUtf8View(JsonView.Buffer, JsonView.Offset + Start, Reader.GetPosition() - Start);
+		}
+		else if (!Reader.SkipValue())
+		{
+			return false;
+		}
+	}
+
+	return !Reader.HasError() && bHasJsonRpc && bHasMethod;
+}
 bool FUMCP_JsonRpcError::ToJsonObject(TSharedPtr<FJsonObject>& OutJsonObject) const
 {
 	// FJsonObjectConverter::UStructToJsonObject will only serialize UPROPERTY members.
@@ -179,6 +270,60 @@ bool FUMCP_JsonRpcResponse::ToJsonString(FString& OutJsonString) const
 	return FJsonSerializer::Serialize(JsonObject.ToSharedRef(), TJsonWriterFactory<>::Create(&OutJsonString));
 }
 
+bool FUMCP_JsonRpcResponse::ToJsonUtf8(TArray<uint8>& OutJsonBytes) const
+{
+	FUMCP_JsonUtf8Writer Writer(OutJsonBytes);
+	Writer.WriteRaw("{\"jsonrpc\":");
+	Writer.WriteString(jsonrpc);
+	Writer.WriteRaw(",\"id\":");
+	Writer.WriteValue(id.GetJsonValue());
+
+	if (error.IsValid())
+	{
+		Writer.WriteRaw(",\"error\":{\"code\":");
+		Writer.WriteNumber(error->code);
+		Writer.WriteRaw(",\"message\":");
+		Writer.WriteString(error->message);
+		if (error->data.IsValid())
+		{
+			Writer.WriteRaw(",\"data\":");
+			Writer.WriteValue(error->data);
+		}
+		Writer.WriteRaw("}");
+	}
+	else if (encodedResult.IsValid())
+	{
+		// Splice the pre-encoded result into the envelope rather than re-serializing it
+		Writer.WriteRaw(",\"result\":");
+		Writer.WriteRaw(*encodedResult);
+	}
+	else if (result.IsValid())
+	{
+		Writer.WriteRaw(",\"result\":");
+		Writer.WriteValue(result);
+	}
+	Writer.WriteRaw("}");
+	return true;
+}
+
+int64 FUMCP_JsonRpcResponse::EstimateJsonUtf8Size() const
+{
+	int64 Size = 64;
+	if (error.IsValid())
+	{
+		Size += error->message.Len() + FUMCP_JsonUtf8Writer::EstimateSize(error->data);
+	}
+	else if (encodedResult.IsValid())
+	{
+		Size += encodedResult->Num();
+	}
+	else
+	{
+		Size += FUMCP_JsonUtf8Writer::EstimateSize(result);
+	}
+	return Size;
+}
+
 bool FUMCP_JsonRpcResponse::CreateFromJsonString(const FString& JsonString, FUMCP_JsonRpcResponse& OutResponse)
 {
 	TSharedPtr<FJsonObject> RootJsonObject;
@@ -293,8 +293,9 @@ bool FUMCP_UriTemplate::FindMatch(const FString& Uri, FUMCP_UriTemplateMatch& Ou
 
     	for (auto VarItr = MatchedVars.CreateConstIterator(); VarItr; ++VarItr)
     	{
+    		// Query expressions are name=value pairs, in any order; elsewhere an = is just part of the value
     		FString VarName, VarValue;
-    		const bool bIsNamed = (*VarItr).Split(TEXT("="), &VarName, &VarValue, ESearchCase::Type::CaseSensitive);
+    		const bool bIsNamed = CurrentComponent.AllowsNamedVars() && (*VarItr).Split(TEXT("="), &VarName, &VarValue, ESearchCase::Type::CaseSensitive);
     		if (bIsNamed)
     		{
     			const FUMCP_UriTemplateComponentVarSpec* VarSpec = CurrentComponent.VarSpecs.FindByPredicate([&VarName](const FUMCP_UriTemplateComponentVarSpec& VarSpec)
@@ -306,8 +307,8 @@ bool FUMCP_UriTemplate::FindMatch(const FString& Uri, FUMCP_UriTemplateMatch& Ou
     				return false;
     			}
 
-    			// TODO
-    			return false;
+    			OutMatch.Variables.FindOrAdd(VarSpec->Val).Add(FPlatformHttp::UrlDecode(VarValue));
+    			continue;
     		}
 
     		if (!CurrentComponent.VarSpecs.IsValidIndex(VarItr.GetIndex()))
@@ -11,8 +11,10 @@ DEFINE_LOG_CATEGORY(LogUnrealMCPServer);
 void FUnrealMCPServerModule::StartupModule()
 {
 	UE_LOG(LogUnrealMCPServer, Warning, TEXT("FUnrealMCPServerModule has started"));
-	CommonTools = MakeUnique<FUMCP_CommonTools>();
-	CommonResources = MakeUnique<FUMCP_CommonResources>();
+	// The export tool and the T3D resource serve the same exports
+	TSharedRef<FUMCP_T3DExportCache> ExportCache = MakeShared<FUMCP_T3DExportCache>();
+	CommonTools = MakeUnique<FUMCP_CommonTools>(ExportCache);
+	CommonResources = MakeUnique<FUMCP_CommonResources>(ExportCache);
 	Server = MakeUnique<FUMCP_Server>();
 	if (Server)
 	{
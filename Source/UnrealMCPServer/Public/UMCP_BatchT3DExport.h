@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UMCP_Types.h"
+
+class FUMCP_GameThreadScheduler;
+class FUMCP_T3DExportCache;
+
+/**
+ * Exports a batch of Blueprints to T3D without hitching the editor on loading them. Every package is requested with
+ * LoadPackageAsync up front; each export is queued on the game thread scheduler as its package arrives, so exports
+ * share the per-frame budget with the rest of the server's work. Results come out in the order the loads finish.
+ */
+class UNREALMCPSERVER_API FUMCP_BatchT3DExport : public TSharedFromThis<FUMCP_BatchT3DExport>
+{
+public:
+	// Game thread only. With bInStream and a client listening for notifications, each export is sent as a partial result
+	// and the final result only carries the summary.
+	static void Start(TArray<FString>&& InBlueprintPaths, bool bInStream, const TSharedRef<FUMCP_T3DExportCache>& InExportCache,
+		const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion);
+
+	FUMCP_BatchT3DExport(TArray<FString>&& InBlueprintPaths, bool bInStream, const TSharedRef<FUMCP_T3DExportCache>& InExportCache,
+		const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion);
+
+private:
+	void OnPackageLoaded(int32 Index, bool bLoaded);
+	void ExportOne(int32 Index, bool bLoaded);
+	void Finish();
+
+	TArray<FString> BlueprintPaths;
+	bool bStream = false;
+	TSharedRef<FUMCP_T3DExportCache> ExportCache;
+	// Weak, a load finishing after the server has gone has nowhere to queue its export
+	TWeakPtr<FUMCP_GameThreadScheduler> Scheduler;
+	TSharedRef<FUMCP_ToolCallCompletion> Completion;
+	// Kept when not streaming, in completion order
+	TArray<FUMCP_CallToolResultContent> Results;
+	int32 NumFinished = 0;
+	int32 NumFailed = 0;
+};
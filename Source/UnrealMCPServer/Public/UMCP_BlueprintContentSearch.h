@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FUMCP_RequestContext;
+
+/**
+ * Searches the graphs, nodes, pins, variables and components of Blueprints through the data Find-in-Blueprints keeps
+ * for them. That data comes from the asset registry tags, so no Blueprint is loaded. Assets are searched in parallel.
+ */
+class UNREALMCPSERVER_API FUMCP_BlueprintContentSearch
+{
+public:
+	struct FHit
+	{
+		// blueprint, graph, node, pin, variable or component
+		FString Type;
+		// Names of the graph, node and pin the hit is in, separated by slashes
+		FString Location;
+		// Search data field that matched, e.g. Name, DefaultValue or Comment
+		FString Field;
+		FString Text;
+	};
+
+	struct FAssetHits
+	{
+		FSoftObjectPath AssetPath;
+		// At most MaxHitsPerAsset of them
+		TArray<FHit> Hits;
+		int32 TotalHits = 0;
+	};
+
+	struct FResults
+	{
+		// In the order of the assets searched, only those with hits
+		TArray<FAssetHits> Assets;
+		// Assets Find-in-Blueprints has no search data for yet, e.g. ones saved before it was added
+		int32 UnindexedAssets = 0;
+		bool bCancelled = false;
+	};
+
+	// Case-insensitive substring search. Context, when given, is checked for cancellation between assets.
+	static void Search(TConstArrayView<FSoftObjectPath> AssetPaths, const FString& Term, int32 MaxHitsPerAsset, const FUMCP_RequestContext* Context, FResults& OutResults);
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Compact JSON form of a Blueprint: its variables, function signatures and the nodes, pins and links of its graphs.
+ * A fraction of the size of its T3D export, which dumps every property, GUID and position. Game thread only.
+ */
+class UNREALMCPSERVER_API FUMCP_BlueprintGraphExport
+{
+public:
+	// What goes into the export. Parts of graphs imply the graphs themselves.
+	enum class EFields : uint32
+	{
+		None = 0,
+		Variables = 1 << 0,
+		Functions = 1 << 1,
+		Graphs = 1 << 2,
+		Nodes = 1 << 3,
+		Pins = 1 << 4,
+		Links = 1 << 5,
+		// Default values of variables and unconnected input pins
+		Defaults = 1 << 6,
+		Comments = 1 << 7,
+		Positions = 1 << 8,
+		All = (1 << 9) - 1,
+		// Everything but the positions, which mean little without the graph in front of you
+		Default = All & ~Positions,
+	};
+
+	// Names as in EFields, lower-cased. An empty list selects the default fields.
+	static bool ParseFields(TConstArrayView<FString> Names, EFields& OutFields, FString& OutError);
+	// On failure OutJson describes the error
+	static bool Export(const FString& BlueprintPath, EFields Fields, FString& OutJson);
+};
+
+ENUM_CLASS_FLAGS(FUMCP_BlueprintGraphExport::EFields);
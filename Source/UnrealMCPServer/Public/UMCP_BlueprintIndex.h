@@ -0,0 +1,180 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UMCP_TrigramIndex.h"
+
+#include <atomic>
+
+/**
+ * Resident index of the Blueprint assets known to the asset registry, so searches never have to query the registry.
+ * Built on first use and kept current from the registry's added/removed/renamed/updated events, which arrive on the game thread.
+ * Queries can run on any thread.
+ */
+class UNREALMCPSERVER_API FUMCP_BlueprintIndex
+{
+public:
+	struct FQuery
+	{
+		// An asset is a hit when any term that is set matches
+		// Case-insensitive substring of the asset name
+		FString NameTerm;
+		// Name or path of a class, e.g. Actor, BP_Enemy or /Game/AI/BP_Enemy.BP_Enemy_C. Matches the Blueprints
+		// deriving from it directly or through other classes.
+		FString ParentClassTerm;
+		// How many levels below ParentClassTerm to look, 0 for the whole subtree
+		int32 MaxDepth = 0;
+		// Ranks assets by how closely their names resemble this, see FUMCP_FuzzyMatch. Used instead of the other terms.
+		FString FuzzyTerm;
+		// Every asset is a hit, whatever the terms
+		bool bAllAssets = false;
+		// When set, only these assets can be hits
+		const TSet<FSoftObjectPath>* OnlyAssets = nullptr;
+		// Only assets in this folder (and below it when recursive) are considered, empty for everything
+		FString PackagePath;
+		bool bRecursivePaths = true;
+		// Page size, 0 for every hit
+		int32 Limit = 0;
+		// NextCursor of the previous page, empty for the first one
+		FString Cursor;
+	};
+
+	struct FHit
+	{
+		FSoftObjectPath AssetPath;
+		FName AssetName;
+		FName PackagePath;
+		FString ParentClass;
+		bool bNameMatch = false;
+		bool bParentClassMatch = false;
+		// Levels below the queried class when bParentClassMatch, 1 for direct subclasses
+		int32 Depth = 0;
+		// Fuzzy match score, 0 for other queries
+		int32 Score = 0;
+	};
+
+	struct FResults
+	{
+		TArray<FHit> Hits;
+		// All hits of the query, on every page
+		int32 TotalHits = 0;
+		// Set when there are more hits after this page
+		FString NextCursor;
+	};
+
+	FUMCP_BlueprintIndex();
+	~FUMCP_BlueprintIndex();
+
+	// Hits are ordered by package path and asset name, best score first for fuzzy queries. Only the page is ever sorted.
+	// Cursors carry the last position rather than an offset, so paging stays consistent while assets are added or removed.
+	// Returns false for a malformed cursor.
+	bool Search(const FQuery& Query, FResults& OutResults);
+
+	// Changes whenever the registry reports an asset change, so results derived from a search can tell they are stale.
+	// Take it before searching.
+	uint64 GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+private:
+	// A run of characters in SearchChars, which holds every searchable string lower-cased and back to back
+	struct FCharSpan
+	{
+		int32 Offset = 0;
+		int32 Length = 0;
+	};
+
+	struct FEntry
+	{
+		FSoftObjectPath AssetPath;
+		FName AssetName;
+		FName PackagePath;
+		FCharSpan SearchName;
+		FCharSpan SearchPackagePath;
+		// The class this Blueprint generates
+		int32 ClassNode = INDEX_NONE;
+		bool bLive = false;
+	};
+
+	// A class in the hierarchy tree, native or generated by a Blueprint. Only classes that some Blueprint derives from are in it.
+	struct FClassNode
+	{
+		// Object path, e.g. /Script/Engine.Actor or /Game/AI/BP_Enemy.BP_Enemy_C
+		FString Path;
+		int32 SuperClass = INDEX_NONE;
+		TArray<int32> SubClasses;
+		// Entry of the Blueprint generating this class, none for native classes
+		int32 BlueprintEntry = INDEX_NONE;
+		// Set once SuperClass is linked, or known to be a root
+		bool bSuperClassKnown = false;
+	};
+
+	enum class EEventType : uint8
+	{
+		AddedOrUpdated,
+		Removed,
+	};
+
+	struct FPendingEvent
+	{
+		EEventType Type;
+		FSoftObjectPath AssetPath;
+		FAssetData AssetData; // Unset for removals
+	};
+
+	void EnsureBuilt();
+	bool IsBlueprintAsset(const FAssetData& AssetData) const;
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& AssetData);
+	void QueueOrApply(FPendingEvent&& Event);
+	// Links native classes new to the tree to their ancestors, which the registry knows but the asset tags don't
+	void ResolveNativeClasses();
+
+	// The rest expect IndexLock to be held for writing
+	void ApplyEvent(const FPendingEvent& Event);
+	void AddOrUpdateEntry(const FAssetData& AssetData);
+	void RemoveEntry(const FSoftObjectPath& AssetPath);
+	void IndexEntry(int32 EntryIndex);
+	void UnindexEntry(int32 EntryIndex);
+	FCharSpan AddSearchString(FStringView Text);
+	void CompactSearchChars();
+	int32 FindOrAddClassNode(const FString& ClassPath);
+	void SetSuperClass(int32 Node, int32 SuperNode);
+	// Walks the subtrees of the classes named by ClassTerm, producing (entry, depth) pairs sorted by entry
+	void CollectDerivedEntries(const FString& ClassTerm, int32 MaxDepth, TArray<TPair<int32, int32>>& OutEntries) const;
+
+	FStringView GetSearchString(const FCharSpan& Span) const { return FStringView(SearchChars.GetData() + Span.Offset, Span.Length); }
+	// Orders entries by package path, then asset name
+	int32 CompareEntryKey(const FEntry& Entry, FStringView PackagePath, FStringView AssetName) const;
+
+	FRWLock IndexLock;
+	std::atomic<uint64> Generation{ 0 };
+	// Held for the whole initial build, so concurrent first searches don't each scan the registry
+	FCriticalSection BuildLock;
+	bool bBuilt = false;
+	bool bBuilding = false;
+	// Registry events that arrived while the initial snapshot was taken, replayed once it is in
+	TArray<FPendingEvent> PendingEvents;
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TMap<FSoftObjectPath, int32> EntryByPath;
+	TArray<TCHAR> SearchChars;
+	// Characters no live entry points at any more
+	int32 GarbageChars = 0;
+	FUMCP_TrigramIndex NameTrigrams;
+	// Nodes are never removed, so their ids stay valid outside of the lock
+	TArray<FClassNode> ClassNodes;
+	TMap<FString, int32> ClassNodeIds;
+	// By the name after the last dot, and without the _C suffix for generated classes
+	TMultiMap<FString, int32> ClassNodesByName;
+	// Native nodes still to be linked by ResolveNativeClasses
+	TArray<int32> UnresolvedNativeClasses;
+	// UBlueprint and the asset classes deriving from it, e.g. widget and animation Blueprints
+	TSet<FTopLevelAssetPath> BlueprintClasses;
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+};
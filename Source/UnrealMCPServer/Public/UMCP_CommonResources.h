@@ -1,6 +1,7 @@
 #pragma once
 
 #include "UMCP_Types.h"
+#include "UMCP_T3DExportCache.h"
 
 // Forward declarations
 class FUMCP_Server;
@@ -12,6 +13,8 @@ struct FUMCP_ReadResourceResultContent; // Forward declare for the delegate para
 class FUMCP_CommonResources
 {
 public:
+	explicit FUMCP_CommonResources(TSharedRef<FUMCP_T3DExportCache> InExportCache);
+
 	void Register(class FUMCP_Server* Server);
 
 private:
@@ -21,4 +24,13 @@ private:
 	 * URI scheme: unreal+t3d://{filepath}
 	 */
 	bool HandleT3DResourceRequest(const FUMCP_UriTemplate& UriTemplate, const FUMCP_UriTemplateMatch& Match, TArray<FUMCP_ReadResourceResultContent>& OutContent);
+
+	/**
+	 * Handles requests for the compact JSON graph export of Blueprints, see FUMCP_BlueprintGraphExport.
+	 * URI scheme: unreal+bpgraph://{filepath}{?fields}
+	 */
+	bool HandleGraphResourceRequest(const FUMCP_UriTemplate& UriTemplate, const FUMCP_UriTemplateMatch& Match, TArray<FUMCP_ReadResourceResultContent>& OutContent);
+
+	// Shared with the export tool
+	TSharedRef<FUMCP_T3DExportCache> ExportCache;
 };
@@ -1,13 +1,36 @@
 ﻿#pragma once
 
 #include "UMCP_Types.h"
+#include "UMCP_BlueprintIndex.h"
+#include "UMCP_Scheduler.h"
+#include "UMCP_T3DExportCache.h"
 
 class FUMCP_CommonTools
 {
 public:
+	explicit FUMCP_CommonTools(TSharedRef<FUMCP_T3DExportCache> InExportCache);
+
 	void Register(class FUMCP_Server* Server);
 
 private:
-	bool ExportBlueprintToT3D(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent);
+	void ExportBlueprintToT3D(TSharedPtr<FJsonObject> arguments, const TSharedRef<FUMCP_ToolCallCompletion>& Completion);
+	bool ExportBlueprintGraph(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent);
+	void ExportBlueprintsToT3D(TSharedPtr<FJsonObject> arguments, const TSharedRef<FUMCP_ToolCallCompletion>& Completion);
 	bool SearchBlueprints(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent);
+	bool QueryAssetReferences(TSharedPtr<FJsonObject> arguments, TArray<FUMCP_CallToolResultContent>& OutContent);
+
+	// Shared with the unreal+t3d resource
+	TSharedRef<FUMCP_T3DExportCache> ExportCache;
+	// The server's, batch exports and streamed exports queue their work on it
+	TWeakPtr<FUMCP_GameThreadScheduler> GameThreadScheduler;
+
+	// Backs search_blueprints, created on registration
+	TUniquePtr<FUMCP_BlueprintIndex> BlueprintIndex;
+
+	// Encoded search_blueprints results by their normalized arguments, all built at SearchCacheGeneration of the index
+	FCriticalSection SearchCacheLock;
+	uint64 SearchCacheGeneration = 0;
+	TMap<FString, FString> SearchCache;
+	// Keys oldest first, for eviction
+	TArray<FString> SearchCacheOrder;
 };
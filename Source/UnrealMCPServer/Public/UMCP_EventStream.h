@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HttpResultCallback.h"
+#include "UMCP_Types.h"
+
+/**
+ * Server-sent event stream for one POST that the client accepted as text/event-stream.
+ *
+ * FHttpServerModule can only send a response body in one piece, so the stream is delivered as a series of
+ * long polls: the POST returns the events queued so far, and the client resumes with a GET carrying
+ * Last-Event-ID until the stream has delivered its final response. Events can be pushed from any thread;
+ * pollers are only ever completed from Tick on the game thread.
+ */
+class UNREALMCPSERVER_API FUMCP_EventStream
+{
+public:
+	explicit FUMCP_EventStream(uint32 InStreamId);
+
+	uint32 GetStreamId() const { return StreamId; }
+
+	// Queues one JSON-RPC message (already UTF-8 JSON) as an event
+	void PushMessage(const TArray<uint8>& JsonMessage);
+	// Returns the size of the encoded response
+	int32 PushResponse(const FUMCP_JsonRpcResponse& Response);
+	void PushNotification(const FString& Method, const TSharedPtr<FJsonObject>& Params);
+	// Marks the stream complete, pollers are answered right away from then on
+	void Close();
+	bool IsClosed() const;
+	// Size of the events the client has not acknowledged yet, for producers to hold back while it catches up
+	int64 GetPendingBytes() const;
+
+	// Parks a request until there are events after AfterSequence to hand it. Events up to AfterSequence count as delivered.
+	void AddPoller(uint32 AfterSequence, const FHttpResultCallback& OnComplete);
+	// Answers the parked poller if it is due. Returns true once the stream is finished with and can be dropped.
+	bool Tick(double Now);
+
+	// Event ids are "<stream>-<sequence>", so a Last-Event-ID finds its way back to the stream it came from
+	static bool ParseEventId(const FString& EventId, uint32& OutStreamId, uint32& OutSequence);
+
+private:
+	struct FEvent
+	{
+		uint32 Sequence = 0;
+		TArray<uint8> Data; // Fully framed SSE event
+	};
+
+	struct FPoller
+	{
+		uint32 AfterSequence = 0;
+		double Deadline = 0.0;
+		FHttpResultCallback OnComplete;
+	};
+
+	static void CompletePoller(const FHttpResultCallback& OnComplete, TArray<uint8>&& Body);
+
+	const uint32 StreamId;
+	mutable FCriticalSection Lock;
+	uint32 NextSequence = 1;
+	TArray<FEvent> Events;
+	int64 PendingBytes = 0;
+	TOptional<FPoller> Poller;
+	// Pollers replaced by a newer one, answered empty on the next tick
+	TArray<FHttpResultCallback> StalePollers;
+	bool bClosed = false;
+	double LastPollTime = 0.0;
+};
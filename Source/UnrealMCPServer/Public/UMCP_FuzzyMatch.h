@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Scores how closely a name resembles what was typed, for names that are misspelled or abbreviated,
+ * e.g. "PlyrCtrl" for BP_PlayerController. Exact, prefix and substring matches rank above subsequences,
+ * which rank above near misses by edit distance. Case-insensitive.
+ */
+struct UNREALMCPSERVER_API FUMCP_FuzzyMatch
+{
+	static constexpr int32 MaxScore = 1000;
+
+	// 0 when Candidate doesn't resemble Pattern at all, MaxScore when they are equal
+	static int32 Score(FStringView Pattern, FStringView Candidate);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+// A JSON value that still lives, unparsed, inside a shared UTF-8 buffer (usually an HTTP request body)
+struct UNREALMCPSERVER_API FUMCP_JsonUtf8View
+{
+	TSharedPtr<const TArray<uint8>> Buffer; // Keeps the underlying bytes alive
+	int32 Offset = 0;
+	int32 Length = 0;
+
+	FUMCP_JsonUtf8View() = default;
+	FUMCP_JsonUtf8View(TSharedPtr<const TArray<uint8>> InBuffer, int32 InOffset, int32 InLength)
+		: Buffer(MoveTemp(InBuffer)), Offset(InOffset), Length(InLength) {}
+
+	bool IsSet() const { return Buffer.IsValid(); }
+	TArrayView<const uint8> GetBytes() const;
+
+	// Builds a DOM for the viewed value, only call this when the contents are actually needed
+	TSharedPtr<FJsonValue> Parse() const;
+	TSharedPtr<FJsonObject> ParseObject() const;
+	// Reads a top level string member of the viewed object without building a DOM
+	bool TryGetStringField(const FString& FieldName, FString& OutValue) const;
+};
+
+/**
+ * Forward-only JSON reader that works in place on UTF-8 bytes.
+ * Values can be skipped (validated without allocating) or read into the regular FJsonValue DOM.
+ */
+class UNREALMCPSERVER_API FUMCP_JsonUtf8Reader
+{
+public:
+	explicit FUMCP_JsonUtf8Reader(TArrayView<const uint8> InData) : Data(InData) {}
+
+	int32 GetPosition() const { return Pos; }
+	// Next non-whitespace byte without consuming it, 0 at the end of input
+	uint8 Peek();
+	// Consumes the next non-whitespace byte if it is Char
+	bool TryConsume(uint8 Char);
+	// True once only whitespace is left
+	bool IsAtEnd();
+
+	// Validates and steps over one value
+	bool SkipValue();
+	// Reads one value into a DOM
+	TSharedPtr<FJsonValue> ReadValue();
+	bool ReadString(FString& OutString);
+
+	// Iterates the members of an object: call BeginObject once, then NextMember until it returns false.
+	// Check HasError afterwards to tell the end of the object from malformed input.
+	bool BeginObject();
+	bool NextMember(FString& OutKey);
+	// Same for arrays: BeginArray, then NextElement before each value
+	bool BeginArray();
+	bool NextElement();
+
+	bool HasError() const { return bError; }
+
+private:
+	void SkipWhitespace();
+	bool Fail();
+	bool ScanString(TArray<uint8>* OutUtf8);
+	bool ScanNumber(double* OutNumber);
+	bool ScanLiteral(const ANSICHAR* Literal);
+
+	TArrayView<const uint8> Data;
+	int32 Pos = 0;
+	int32 Depth = 0;
+	bool bFirstItem = false;
+	bool bError = false;
+};
+
+/**
+ * Encodes JSON straight into a UTF-8 byte buffer, with no intermediate FString.
+ * Output is condensed (no whitespace), matching what goes out on the wire.
+ */
+class UNREALMCPSERVER_API FUMCP_JsonUtf8Writer
+{
+public:
+	explicit FUMCP_JsonUtf8Writer(TArray<uint8>& InOut) : Out(InOut) {}
+
+	// Appends bytes that are already valid JSON
+	void WriteRaw(const ANSICHAR* Json);
+	void WriteRaw(TArrayView<const uint8> Json) { Out.Append(Json.GetData(), Json.Num()); }
+
+	void WriteString(FStringView String);
+	void WriteNumber(double Number);
+	void WriteBool(bool bValue) { WriteRaw(bValue ? "true" : "false"); }
+	void WriteNull() { WriteRaw("null"); }
+	// A missing value is written as null
+	void WriteValue(const TSharedPtr<FJsonValue>& Value);
+	void WriteObject(const FJsonObject& Object);
+
+	// Rough encoded size of a value, used to reserve the buffer up front so large payloads are not regrown
+	static int64 EstimateSize(const TSharedPtr<FJsonValue>& Value);
+	static int64 EstimateSize(const FJsonObject& Object);
+
+private:
+	TArray<uint8>& Out;
+};
+
+// Splits a request body into its top level JSON-RPC entries.
+// A single value yields one entry, a batch array yields one entry per element.
+UNREALMCPSERVER_API bool UMCP_SplitJsonUtf8Body(const TSharedPtr<const TArray<uint8>>& Body, TArray<FUMCP_JsonUtf8View>& OutEntries, bool& bOutIsBatch);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * Latency histogram over log spaced buckets, four per doubling starting at one microsecond,
+ * so percentiles come out within about 20% of the true value whatever the scale.
+ * Not thread safe on its own, FUMCP_Metrics guards it.
+ */
+class UNREALMCPSERVER_API FUMCP_LatencyHistogram
+{
+public:
+	void Add(double Seconds);
+
+	uint64 GetCount() const { return Count; }
+	// Upper bound of the bucket holding the given percentile (0-100), capped at the largest sample
+	double GetPercentileMs(double Percentile) const;
+	double GetMeanMs() const;
+	double GetMaxMs() const { return MaxSeconds * 1000.0; }
+
+	// { count, meanMs, p50Ms, p95Ms, p99Ms, maxMs }
+	TSharedRef<FJsonObject> ToJson() const;
+
+	static constexpr int32 BucketsPerDoubling = 4;
+	// Covers up to 2^32 microseconds, a bit over an hour
+	static constexpr int32 NumBuckets = 32 * BucketsPerDoubling;
+
+private:
+	uint32 Buckets[NumBuckets] = {};
+	uint64 Count = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+};
+
+/**
+ * Request counters and latency histograms for the MCP endpoint, kept per method and per tool.
+ * Recorded from whichever thread finishes the work and read through ToJson, which backs the unreal+metrics://server resource.
+ */
+class UNREALMCPSERVER_API FUMCP_Metrics
+{
+public:
+	// Where the time of one JSON-RPC call went
+	struct FCallTiming
+	{
+		double QueueWaitSeconds = 0.0; // Dispatch until the handler started, mostly game thread queueing
+		double ExecuteSeconds = 0.0; // Handler start until its response, including asynchronous completion
+	};
+
+	FUMCP_Metrics();
+
+	// One POST body, and how long it took to split into entries
+	void RecordHttpRequest(int32 BodyBytes, double ParseSeconds);
+	// One reply, as a plain JSON body or a response pushed to an event stream, and how long encoding it took
+	void RecordHttpResponse(int32 PayloadBytes, double SerializeSeconds);
+	void RecordMethodCall(const FString& Method, int32 RequestBytes, const FCallTiming& Timing, bool bError, bool bCancelled);
+	void RecordMethodResponseBytes(const FString& Method, int32 ResponseBytes);
+	void RecordToolCall(const FString& ToolName, double Seconds, bool bError);
+
+	TSharedRef<FJsonObject> ToJson() const;
+
+private:
+	struct FMethodMetrics
+	{
+		uint64 Calls = 0;
+		uint64 Errors = 0;
+		uint64 Cancelled = 0;
+		uint64 RequestBytes = 0;
+		uint64 ResponseBytes = 0;
+		FUMCP_LatencyHistogram QueueWait;
+		FUMCP_LatencyHistogram Execute;
+		FUMCP_LatencyHistogram Total;
+	};
+
+	struct FToolMetrics
+	{
+		uint64 Calls = 0;
+		uint64 Errors = 0;
+		FUMCP_LatencyHistogram Duration;
+	};
+
+	mutable FCriticalSection Lock;
+	double StartTime = 0.0;
+	uint64 HttpRequests = 0;
+	uint64 HttpRequestBytes = 0;
+	uint64 HttpResponses = 0;
+	uint64 HttpResponseBytes = 0;
+	FUMCP_LatencyHistogram Parse;
+	FUMCP_LatencyHistogram Serialize;
+	TMap<FString, FMethodMetrics> Methods;
+	TMap<FString, FToolMetrics> ToolCalls;
+};
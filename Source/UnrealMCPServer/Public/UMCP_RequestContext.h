@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UMCP_Types.h"
+
+class FUMCP_EventStream;
+
+/**
+ * Per-request state that tools and resource readers can reach while they run.
+ * The context of the request being handled on the calling thread is available from GetCurrent().
+ * Asynchronous handlers keep it alive through their completion handle, see TUMCP_AsyncCompletion::GetContext.
+ */
+class UNREALMCPSERVER_API FUMCP_RequestContext : public TSharedFromThis<FUMCP_RequestContext>
+{
+public:
+	FUMCP_RequestContext(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FUMCP_EventStream> InEventStream, const FString& InSessionKey);
+
+	// Context of the request executing on this thread, or nullptr outside of a handler
+	static FUMCP_RequestContext* GetCurrent();
+
+	const FUMCP_JsonRpcId& GetRequestId() const { return RequestId; }
+	// Mcp-Session-Id of the client, or its address when it has none
+	const FString& GetSessionKey() const { return SessionKey; }
+	// Work that outlives the handler, e.g. on another thread, can hold on to the token instead of the whole context
+	const TSharedRef<FUMCP_CancellationToken>& GetCancellationToken() const { return CancellationToken; }
+	bool IsCancelled() const { return CancellationToken->IsCancelled(); }
+	// True when the client takes the response as an event stream, so intermediate messages reach it
+	bool IsStreaming() const { return EventStream.IsValid(); }
+	// Bytes sent on the event stream that the client has not picked up yet, 0 when not streaming
+	int64 GetPendingStreamBytes() const;
+
+	// Sends notifications/progress, if the client asked for it with a progressToken. Updates are rate limited.
+	void ReportProgress(double Progress, double Total = 0.0, const FString& Message = FString());
+	// Sends part of a tool result ahead of the final response. Content sent this way is not repeated in the result.
+	void SendPartialContent(const TArray<FUMCP_CallToolResultContent>& Content);
+
+	static const FString PartialResultNotification;
+
+private:
+	FUMCP_JsonRpcId RequestId;
+	FString SessionKey;
+	TSharedRef<FUMCP_CancellationToken> CancellationToken;
+	TSharedPtr<FJsonValue> ProgressToken;
+	TSharedPtr<FUMCP_EventStream> EventStream;
+	double LastProgressTime = 0.0;
+};
+
+// Makes a context current on this thread for the lifetime of the scope
+class UNREALMCPSERVER_API FUMCP_RequestContextScope
+{
+public:
+	explicit FUMCP_RequestContextScope(FUMCP_RequestContext& Context);
+	~FUMCP_RequestContextScope();
+
+private:
+	FUMCP_RequestContext* PreviousContext;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EUMCP_ContentEncoding : uint8
+{
+	Identity,
+	Gzip,
+	Deflate,
+};
+
+/**
+ * Content-Encoding for HTTP responses, negotiated from the request's Accept-Encoding.
+ * JSON-RPC results like T3D exports and search pages are repetitive text that shrinks several times over, which
+ * matters to clients reaching the editor over a network rather than on localhost.
+ */
+class UNREALMCPSERVER_API FUMCP_ResponseCompression
+{
+public:
+	// The supported encoding the client prefers, by q-value, gzip winning ties. Identity when it accepts neither.
+	static EUMCP_ContentEncoding Negotiate(const FString& AcceptEncoding);
+	// Value for the Content-Encoding header
+	static const TCHAR* GetHeaderValue(EUMCP_ContentEncoding Encoding);
+	// Compresses Payload in place. Leaves it as it is and returns false when that fails or doesn't make it smaller.
+	static bool Compress(EUMCP_ContentEncoding Encoding, TArray<uint8>& Payload);
+};
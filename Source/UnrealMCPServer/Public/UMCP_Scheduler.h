@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// Order in which queued game thread work is picked, cheap interactive calls ahead of heavy tool calls
+enum class EUMCP_RequestPriority : uint8
+{
+	High,
+	Normal,
+	Low,
+	Count
+};
+
+/**
+ * Runs MCP work on the game thread without letting a burst of requests stall the editor.
+ * Work is queued from any thread and drained from a core ticker until the per-frame budget
+ * (UMCP.GameThreadBudgetMs) is spent. Higher priorities go first; within a priority, sessions take turns.
+ * Work queued while the queue drains runs on the next frame at the earliest.
+ */
+class UNREALMCPSERVER_API FUMCP_GameThreadScheduler
+{
+public:
+	~FUMCP_GameThreadScheduler();
+
+	void Start();
+	// Drops anything still queued, calling OnDropped for each item instead of its work. Work queued after this is dropped right away.
+	void Stop();
+
+	// Queues work for the game thread. SessionKey groups requests from the same client for round-robin.
+	// OnDropped runs instead of Work if the scheduler stops first, so whoever waits on the work still gets an answer.
+	void Enqueue(const FString& SessionKey, EUMCP_RequestPriority Priority, TUniqueFunction<void()>&& Work, TUniqueFunction<void()>&& OnDropped = nullptr);
+
+	int32 GetQueueDepth() const;
+	// Longest time an item spent queued before it ran during the last drain
+	double GetLastMaxWaitMs() const;
+	// Smoothed time items spend queued before they run
+	double GetAverageWaitMs() const;
+
+private:
+	struct FWorkItem
+	{
+		TUniqueFunction<void()> Work;
+		TUniqueFunction<void()> OnDropped;
+		double EnqueueTime = 0.0;
+	};
+
+	struct FSessionQueue
+	{
+		FString SessionKey;
+		TArray<FWorkItem> Items;
+		int32 Head = 0;
+	};
+
+	struct FPriorityQueue
+	{
+		TArray<FSessionQueue> Sessions;
+		int32 NextSession = 0;
+	};
+
+	bool Tick(float DeltaTime);
+	bool Dequeue(FWorkItem& OutItem);
+
+	mutable FCriticalSection Lock;
+	FPriorityQueue Queues[static_cast<int32>(EUMCP_RequestPriority::Count)];
+	int32 QueueDepth = 0;
+	bool bStopped = false;
+	double LastMaxWaitMs = 0.0;
+	double AverageWaitMs = 0.0;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
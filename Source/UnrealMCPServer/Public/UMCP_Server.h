@@ -7,6 +7,14 @@
 #include "IHttpRouter.h"
 #include "UMCP_Types.h"
 #include "UMCP_UriTemplate.h"
+#include "UMCP_Scheduler.h"
+#include "UMCP_Metrics.h"
+#include "UMCP_ResponseCompression.h"
+#include "Containers/Ticker.h"
+
+class FUMCP_EventStream;
+class FUMCP_RequestContext;
+class FUMCP_CancellationToken;
 
 // Forward declarations for JSON types (used in helpers)
 struct FUMCP_JsonRpcResponse;
@@ -14,6 +22,24 @@ struct FUMCP_JsonRpcError;
 struct FUMCP_JsonRpcId;
 using UMCP_JsonRpcHandler = TFunction<bool(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError)>;
 
+// Like UMCP_JsonRpcHandler, but hands back the result already encoded as UTF-8 JSON
+using UMCP_JsonRpcEncodedHandler = TFunction<bool(const FUMCP_JsonRpcRequest& Request, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError)>;
+
+// Finishes an asynchronous method call with either a result object or an error
+using UMCP_JsonRpcCompletion = TFunction<void(TSharedPtr<FJsonObject> Result, TSharedPtr<FUMCP_JsonRpcError> Error)>;
+// Like UMCP_JsonRpcHandler, but the response is only sent once OnComplete is called, from any thread
+using UMCP_JsonRpcAsyncHandler = TFunction<void(const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete)>;
+
+struct FUMCP_JsonRpcMethod
+{
+	UMCP_JsonRpcHandler Handler;
+	UMCP_JsonRpcEncodedHandler EncodedHandler;
+	UMCP_JsonRpcAsyncHandler AsyncHandler;
+	EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread;
+	// Only matters for requests queued for the game thread
+	EUMCP_RequestPriority Priority = EUMCP_RequestPriority::Normal;
+};
+
 class UNREALMCPSERVER_API FUMCP_Server
 {
 public:
@@ -21,33 +47,98 @@ public:
 	void StopServer();
 
 	// Method handlers should return true for success/error (indicating which object to use in the JSON RPC response)
-	void RegisterRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcHandler&& Handler);
+	// ThreadAffinity picks where the handler runs; tools and resources declare theirs on their definitions.
+	void RegisterRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread);
+	void RegisterAsyncRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcAsyncHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread);
+	// Where a method's game thread work sits in the queue, relative to other methods
+	void SetRpcMethodPriority(const FString& MethodName, EUMCP_RequestPriority Priority);
 	bool RegisterTool(FUMCP_ToolDefinition Tool);
 	bool RegisterResource(FUMCP_ResourceDefinition Resource);
 	bool RegisterResourceTemplate(FUMCP_ResourceTemplateDefinition ResourceTemplate);
+	// For asynchronous tools to queue their own game thread work under the same budget. Hold it weakly, it goes with the server.
+	TSharedRef<FUMCP_GameThreadScheduler> GetGameThreadScheduler() const { return GameThreadScheduler; }
+
+	// The client a request comes from: the Mcp-Session-Id issued at initialize, or the peer's host without one.
+	// Requests take turns for game thread time by it, and only it can cancel them.
+	static FString GetSessionKey(const FHttpServerRequest& Request);
+	// Requests are tracked from dispatch until their response, so notifications/cancelled can reach them
+	static FString GetInFlightKey(const FString& SessionKey, const FUMCP_JsonRpcId& RequestId);
 private:
-    void HandleStreamableHTTPMCPRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+    void HandleStreamableHTTPMCPRequest(const TSharedRef<const FHttpServerRequest>& Request, const FHttpResultCallback& OnComplete);
+    void HandleStreamableHTTPMCPGetRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
 
     static const FString MCP_PROTOCOL_VERSION;
     static const FString PLUGIN_VERSION;
 	
     // Helper methods for sending responses
-    static void SendJsonRpcResponse(const FHttpResultCallback& OnComplete, const FUMCP_JsonRpcResponse& Response);
+    static int32 SendJsonRpcResponse(const FHttpResultCallback& OnComplete, const FUMCP_JsonRpcResponse& Response, EUMCP_ContentEncoding Encoding = EUMCP_ContentEncoding::Identity);
+    static int32 SendJsonRpcBatchResponse(const FHttpResultCallback& OnComplete, const TArray<FUMCP_JsonRpcResponse>& Responses, TArray<int32>* OutResponseSizes = nullptr, EUMCP_ContentEncoding Encoding = EUMCP_ContentEncoding::Identity);
+    static void SendJsonPayload(const FHttpResultCallback& OnComplete, TArray<uint8>&& JsonPayload, EUMCP_ContentEncoding Encoding = EUMCP_ContentEncoding::Identity);
+    static void SendAccepted(const FHttpResultCallback& OnComplete);
+    static void CompleteOnGameThread(const FHttpResultCallback& OnComplete, TUniquePtr<FHttpServerResponse>&& Response);
+
+    struct FPendingRpcEntries;
+    static void SendPendingResponses(FPendingRpcEntries& Pending);
+    void DispatchRpcEntries(const TArray<FUMCP_JsonUtf8View>& Entries, bool bIsBatch, bool bAcceptsEventStream, EUMCP_ContentEncoding ContentEncoding, const FString& SessionKey, bool bHasSessionId, const FHttpResultCallback& OnComplete);
+    using FUMCP_JsonRpcResponseCallback = TFunction<void(FUMCP_JsonRpcResponse&& Response)>;
+    // Runs the handler for a request; OnResponse may be called later and from another thread for asynchronous handlers
+    void ExecuteRpcRequest(const FUMCP_JsonRpcRequest& RpcRequest, const TSharedRef<FUMCP_RequestContext>& Context, FUMCP_JsonRpcResponseCallback&& OnResponse);
+    EUMCP_ThreadAffinity GetRequestAffinity(const FUMCP_JsonRpcRequest& RpcRequest) const;
+    EUMCP_RequestPriority GetRequestPriority(const FUMCP_JsonRpcRequest& RpcRequest) const;
+
+	// Encoded list results, rebuilt only when the registries change generation
+	struct FEncodedResultCache
+	{
+		uint32 Generation = 0;
+		TSharedPtr<const TArray<uint8>> EncodedResult;
+	};
+	bool GetCachedResult(FEncodedResultCache& Cache, const FUMCP_JsonRpcRequest& Request, const UMCP_JsonRpcHandler& BuildResult, TSharedPtr<const TArray<uint8>>& OutEncodedResult, FUMCP_JsonRpcError& OutError);
+
+	void TrackInFlightRequest(const FUMCP_RequestContext& Context);
+	void UntrackInFlightRequest(const FUMCP_RequestContext& Context);
+
+	TSharedRef<FUMCP_EventStream> CreateEventStream();
+	bool TickEventStreams(float DeltaTime);
 
+	void RegisterEncodedRpcMethodHandler(const FString& MethodName, UMCP_JsonRpcEncodedHandler&& Handler, EUMCP_ThreadAffinity ThreadAffinity);
 	void RegisterInternalRpcMethodHandlers();
+	void RegisterInternalResources();
+	bool ReadMetricsResource(const FString& Uri, TArray<FUMCP_ReadResourceResultContent>& OutContent);
 	bool Rpc_Initialize(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
 	bool Rpc_Ping(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
 	bool Rpc_ClientNotifyInitialized(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
+	bool Rpc_ClientNotifyCancelled(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
 	bool Rpc_ToolsList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
-	bool Rpc_ToolsCall(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
+	void Rpc_ToolsCall(const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete);
 	bool Rpc_ResourcesList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
 	bool Rpc_ResourcesTemplatesList(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
-	bool Rpc_ResourcesRead(const FUMCP_JsonRpcRequest& Request, TSharedPtr<FJsonObject> OutSuccess, FUMCP_JsonRpcError& OutError);
+	void Rpc_ResourcesRead(const FUMCP_JsonRpcRequest& Request, UMCP_JsonRpcCompletion&& OnComplete);
 
     TSharedPtr<IHttpRouter> HttpRouter;
     uint32 HttpServerPort = 30069;
-	TMap<FString, UMCP_JsonRpcHandler> JsonRpcMethodHandlers;
+	// Guards the handler, tool and resource registries, which requests read from worker threads
+	mutable FRWLock RegistryLock;
+	TMap<FString, FUMCP_JsonRpcMethod> JsonRpcMethodHandlers;
+	// Bumped whenever a tool, resource or resource template is registered
+	uint32 RegistryGeneration = 1;
+	FCriticalSection ResultCacheLock;
+	FEncodedResultCache ToolsListCache;
+	FEncodedResultCache ResourcesListCache;
+	FEncodedResultCache ResourceTemplatesListCache;
     FHttpRouteHandle RouteHandle_MCPStreamableHTTP;
+    FHttpRouteHandle RouteHandle_MCPStreamableHTTPGet;
+	// Event streams that POSTs were answered with, kept until their client stops polling
+	FCriticalSection EventStreamsLock;
+	TMap<uint32, TSharedPtr<FUMCP_EventStream>> EventStreams;
+	uint32 NextEventStreamId = 1;
+	FTSTicker::FDelegateHandle EventStreamTickerHandle;
+	// Cancellation tokens of requests awaiting their response, by GetInFlightKey
+	FCriticalSection InFlightLock;
+	TMap<FString, TSharedRef<FUMCP_CancellationToken>> InFlightRequests;
+	// All game thread work for requests goes through here, shared with tools that queue more of it later
+	TSharedRef<FUMCP_GameThreadScheduler> GameThreadScheduler = MakeShared<FUMCP_GameThreadScheduler>();
+	// Shared with pending requests, which record into it as they finish
+	TSharedRef<FUMCP_Metrics> Metrics = MakeShared<FUMCP_Metrics>();
 	TMap<FString, FUMCP_ToolDefinition> Tools;
 	TMap<FString, FUMCP_ResourceDefinition> Resources;
 	TArray<TPair<FUMCP_UriTemplate, FUMCP_ResourceTemplateDefinition>> ResourceTemplates;
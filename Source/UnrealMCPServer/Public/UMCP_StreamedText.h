@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UMCP_Types.h"
+
+class FUMCP_GameThreadScheduler;
+
+/**
+ * Sends a large text result as partial results, no faster than the client reads them. Event streams only reach the
+ * client when it polls, so chunks are sent on the game thread scheduler a few at a time, and only while less than
+ * MaxPendingBytes of the stream is still waiting to be picked up. The event stream never holds more than about that
+ * much of the text on top of the text itself.
+ */
+class UNREALMCPSERVER_API FUMCP_StreamedText : public TSharedFromThis<FUMCP_StreamedText>
+{
+public:
+	// Completes with FinalContent once the last chunk is sent. The completion's context must be streaming.
+	static void Start(FString&& InText, int32 InChunkChars, int64 InMaxPendingBytes, TArray<FUMCP_CallToolResultContent>&& InFinalContent,
+		const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion);
+
+	FUMCP_StreamedText(FString&& InText, int32 InChunkChars, int64 InMaxPendingBytes, TArray<FUMCP_CallToolResultContent>&& InFinalContent,
+		const TSharedRef<FUMCP_GameThreadScheduler>& InScheduler, const TSharedRef<FUMCP_ToolCallCompletion>& InCompletion);
+
+private:
+	void SendChunks();
+	void Queue();
+	void Fail(const FString& Message);
+
+	FString Text;
+	int32 Offset = 0;
+	int32 ChunkChars;
+	int64 MaxPendingBytes;
+	TArray<FUMCP_CallToolResultContent> FinalContent;
+	// Weak, the server may stop while the client is still reading
+	TWeakPtr<FUMCP_GameThreadScheduler> Scheduler;
+	TSharedRef<FUMCP_ToolCallCompletion> Completion;
+	// For giving up on a client that stopped reading
+	int64 LastPendingBytes = 0;
+	double LastProgressTime = 0.0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IO/IoHash.h"
+
+/**
+ * T3D exports of Blueprints, shared by the export tool and the unreal+t3d resource.
+ * Every export is tagged with a version, a hash of its text. The newest version of a Blueprint is handed out again for
+ * as long as the saved hash the asset registry has for its package stays the same, so resaving a Blueprint invalidates
+ * it without any notification. Packages with unsaved changes are always exported fresh.
+ * The last few versions of each Blueprint are kept, so a client holding an older one can be sent a diff instead.
+ * The total size of the versions kept is bounded, the least recently used go first. Game thread only, like exporting itself.
+ */
+class UNREALMCPSERVER_API FUMCP_T3DExportCache
+{
+public:
+	enum class EExportStatus : uint8
+	{
+		Full,
+		Diff,
+		NotModified,
+	};
+
+	struct FVersionedExport
+	{
+		// The whole export, a unified diff from BaseVersion to it, or empty when not modified
+		FString Text;
+		FString Version;
+		FString BaseVersion;
+		EExportStatus Status = EExportStatus::Full;
+
+		// Version and status as a small JSON object, to send along with Text
+		FString GetInfoJson() const;
+	};
+
+	// Exports the Blueprint at BlueprintPath, or hands out the cached export. On failure OutText describes the error.
+	bool Export(const FString& BlueprintPath, FString& OutText, FString* OutVersion = nullptr);
+	// Export for a client that may hold KnownVersion already. Not modified when that is still the version, a diff when
+	// that version is still kept and the diff comes out smaller than the export, the whole export otherwise.
+	bool ExportSince(const FString& BlueprintPath, const FString& KnownVersion, FVersionedExport& OutExport, FString& OutError);
+
+private:
+	struct FVersion
+	{
+		uint64 Hash = 0;
+		FString Text;
+		uint64 LastUse = 0;
+	};
+
+	struct FEntry
+	{
+		// Set while the newest version is the export of this saved package
+		FIoHash SavedHash;
+		// Oldest first
+		TArray<FVersion> Versions;
+	};
+
+	// The newest version of BlueprintPath if it is current. bOutCacheable tells whether a new export could become current.
+	FVersion* FindCurrent(const FString& BlueprintPath, FIoHash& OutSavedHash, bool& bOutCacheable);
+	FVersion* FindVersion(const FString& BlueprintPath, const FString& Version);
+	// Keeps Text as the newest version of BlueprintPath, current for SavedHash unless that is zero
+	void AddVersion(const FString& BlueprintPath, const FIoHash& SavedHash, uint64 Hash, const FString& Text);
+	void Trim(int64 MaxBytes);
+
+	TMap<FString, FEntry> Entries;
+	int64 TotalBytes = 0;
+	uint64 UseCounter = 0;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Line diffs between two versions of a text, so a client holding the old one only needs the changes.
+ * Uses Myers' O((N+M)D) algorithm after stripping the common head and tail, which is most of an edited export.
+ */
+class UNREALMCPSERVER_API FUMCP_TextDiff
+{
+public:
+	// Writes a unified diff without context lines, empty when the texts are equal. Gives up and returns false when
+	// more than MaxEdits lines were inserted or deleted, by then the new text is the cheaper thing to send.
+	static bool MakeUnifiedDiff(const FString& OldText, const FString& NewText, FString& OutDiff, int32 MaxEdits = 1000);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Posting lists from each three character sequence to the ids of the strings containing it.
+ * A substring query intersects the lists of its own trigrams, which leaves a small candidate set
+ * that still has to be checked against the actual strings. Strings are expected lower-cased already.
+ * Not thread safe on its own.
+ */
+class UNREALMCPSERVER_API FUMCP_TrigramIndex
+{
+public:
+	static constexpr int32 MinTermLength = 3;
+
+	void Add(int32 Id, FStringView Text);
+	// Text must be what the id was added with
+	void Remove(int32 Id, FStringView Text);
+
+	// Sorted ids of the strings that contain every trigram of Term. Returns false if Term is too short
+	// to narrow anything down, in which case the caller has to scan.
+	bool FindCandidates(FStringView Term, TArray<int32>& OutIds) const;
+
+private:
+	static void GetTrigrams(FStringView Text, TArray<uint64>& OutTrigrams);
+
+	// Each list is kept sorted, so lookups can intersect them in one pass
+	TMap<uint64, TArray<int32>> Postings;
+};
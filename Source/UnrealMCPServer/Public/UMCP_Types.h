@@ -6,6 +6,8 @@
 #include "JsonUtilities.h"
 #include "Serialization/JsonSerializer.h"
 #include "UMCP_UriTemplate.h"
+#include "UMCP_JsonUtf8.h"
+#include <atomic>
 #include "UMCP_Types.generated.h"
 
 // Standard JSON-RPC 2.0 Error Codes & MCP Specific Codes
@@ -27,6 +29,15 @@ enum class EUMCP_JsonRpcErrorCode : int32
     // Example: OperationNotSupported = -32001,
 };
 
+// Where the body of a method handler, tool or resource reader is executed.
+// Request parsing and response serialization always happen on a worker thread.
+enum class EUMCP_ThreadAffinity : uint8
+{
+    AnyThread,  // Run inline on the worker that parsed the request. Handler must be thread-safe and cheap.
+    GameThread, // Marshalled to the game thread. Required for anything touching UObjects or editor state.
+    WorkerPool, // Run on a background task graph worker. For thread-safe but long running work.
+};
+
 // Represents a JSON-RPC Request ID, which can be a string, number, or null.
 // Also handles the concept of an "absent" ID for notifications that don't send one.
 USTRUCT()
@@ -52,6 +63,7 @@ public:
     bool IsString() const;
     bool IsNumber() const;
     bool IsNull() const;
+    bool IsAbsent() const;
 
     TSharedPtr<FJsonValue> GetJsonValue() const;
     FString ToString() const;
@@ -71,12 +83,24 @@ struct FUMCP_JsonRpcRequest
     UPROPERTY()
     FString method;
 
-    TSharedPtr<FJsonObject> params; // Using TSharedPtr<FJsonObject> for params
+    // Parsed lazily from paramsView on the first GetParams() call
+    mutable TSharedPtr<FJsonObject> params;
+    // Unparsed 'params' object inside the request body
+    FUMCP_JsonUtf8View paramsView;
     FUMCP_JsonRpcId id;
 
     FUMCP_JsonRpcRequest() : jsonrpc(TEXT("2.0")) {}
+    // Notifications are requests sent without an 'id' member; they never receive a response.
+    bool IsNotification() const { return id.IsAbsent(); }
+    // Params object, or nullptr if the request has none
+    TSharedPtr<FJsonObject> GetParams() const;
+    // Reads a top level string param without building the params DOM
+    bool TryGetParamsStringField(const FString& FieldName, FString& OutValue) const;
     bool ToJsonString(FString& OutJsonString) const;
     static bool CreateFromJsonString(const FString& JsonString, FUMCP_JsonRpcRequest& OutRequest);
+    static bool CreateFromJsonObject(const TSharedPtr<FJsonObject>& RootJsonObject, FUMCP_JsonRpcRequest& OutRequest);
+    // Reads the envelope straight from UTF-8 bytes. 'params' is only located, not parsed.
+    static bool CreateFromJsonUtf8(const FUMCP_JsonUtf8View& JsonView, FUMCP_JsonRpcRequest& OutRequest);
 };
 
 USTRUCT()
@@ -115,12 +139,19 @@ struct FUMCP_JsonRpcResponse
 
     // Result can be any valid JSON value (object, array, string, number, boolean, null)
     TSharedPtr<FJsonValue> result; 
+
+    // Already encoded UTF-8 JSON for 'result', spliced into the envelope verbatim. Takes precedence over 'result'.
+    TSharedPtr<const TArray<uint8>> encodedResult;
     
     TSharedPtr<FUMCP_JsonRpcError> error; // Error object if an error occurred
 
     FUMCP_JsonRpcResponse() : jsonrpc(TEXT("2.0")) {}
 
     bool ToJsonString(FString& OutJsonString) const;
+    // Appends the response as UTF-8 JSON, the form it goes out on the wire. No FString is built along the way.
+    bool ToJsonUtf8(TArray<uint8>& OutJsonBytes) const;
+    // Approximate size of ToJsonUtf8's output, for reserving the buffer
+    int64 EstimateJsonUtf8Size() const;
     static bool CreateFromJsonString(const FString& JsonString, FUMCP_JsonRpcResponse& OutResponse);
 };
 
@@ -159,7 +190,7 @@ struct FUMCP_ServerCapabilitiesTools
     GENERATED_BODY()
 
     UPROPERTY()
-    bool listChanged = false; // Deferred as SSE is deferred
+    bool listChanged = false; // Needs a standalone GET stream, only POST-initiated event streams are supported
 
     UPROPERTY()
     bool inputSchema = true; // Whether server supports 'inputSchema' in ToolDefinition
@@ -174,10 +205,10 @@ struct FUMCP_ServerCapabilitiesResources
     GENERATED_BODY()
 
     UPROPERTY()
-    bool listChanged = false; // Deferred as SSE is deferred
+    bool listChanged = false; // Needs a standalone GET stream, only POST-initiated event streams are supported
 
     UPROPERTY()
-    bool subscribe = false; // Deferred as SSE is deferred
+    bool subscribe = false; // Needs a standalone GET stream, only POST-initiated event streams are supported
 };
 
 USTRUCT()
@@ -186,7 +217,7 @@ struct FUMCP_ServerCapabilitiesPrompts
     GENERATED_BODY()
 
     UPROPERTY()
-    bool listChanged = false; // Deferred as SSE is deferred
+    bool listChanged = false; // Needs a standalone GET stream, only POST-initiated event streams are supported
 };
 
 USTRUCT()
@@ -300,7 +331,72 @@ struct FUMCP_ListToolsParams
 	FString cursor;
 };
 
+class FUMCP_RequestContext;
+
+/**
+ * Set once the client gives up on a request with notifications/cancelled.
+ * Long running tools should check it every so often and stop early; the server drops the response of a cancelled request either way.
+ */
+class FUMCP_CancellationToken
+{
+public:
+	void Cancel() { bCancelled.store(true, std::memory_order_relaxed); }
+	bool IsCancelled() const { return bCancelled.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<bool> bCancelled{ false };
+};
+
+/**
+ * Handed to asynchronous tools and resource readers. Call Complete exactly once, from any thread, when the work resolves;
+ * the response is only sent then. A handle released without being completed fails the request rather than leaving it hanging.
+ */
+template<typename ContentType>
+class TUMCP_AsyncCompletion
+{
+public:
+	using FOnComplete = TFunction<void(bool /* bSuccess */, TArray<ContentType>&& /* Content */)>;
+
+	TUMCP_AsyncCompletion(FOnComplete&& InOnComplete, TSharedPtr<FUMCP_RequestContext> InContext, TSharedPtr<const FUMCP_CancellationToken> InCancellationToken)
+		: OnComplete(MoveTemp(InOnComplete)), Context(MoveTemp(InContext)), CancellationToken(MoveTemp(InCancellationToken)) {}
+
+	~TUMCP_AsyncCompletion()
+	{
+		if (!IsCompleted())
+		{
+			Complete(false, TArray<ContentType>());
+		}
+	}
+
+	void Complete(bool bSuccess, TArray<ContentType>&& Content)
+	{
+		if (bCompleted.exchange(true))
+		{
+			return;
+		}
+		FOnComplete Callback = MoveTemp(OnComplete);
+		Callback(bSuccess, MoveTemp(Content));
+	}
+
+	bool IsCompleted() const { return bCompleted.load(); }
+	// The request this call belongs to, for reporting progress from wherever the work ends up running
+	const TSharedPtr<FUMCP_RequestContext>& GetContext() const { return Context; }
+	// True once the client cancelled the request; the work may stop and complete with whatever it has
+	bool IsCancelled() const { return CancellationToken.IsValid() && CancellationToken->IsCancelled(); }
+	const TSharedPtr<const FUMCP_CancellationToken>& GetCancellationToken() const { return CancellationToken; }
+
+private:
+	FOnComplete OnComplete;
+	TSharedPtr<FUMCP_RequestContext> Context;
+	TSharedPtr<const FUMCP_CancellationToken> CancellationToken;
+	std::atomic<bool> bCompleted{ false };
+};
+
+using FUMCP_ToolCallCompletion = TUMCP_AsyncCompletion<FUMCP_CallToolResultContent>;
+
 DECLARE_DELEGATE_RetVal_TwoParams(bool, FUMCP_ToolCall, TSharedPtr<FJsonObject> /* arguments */, TArray<FUMCP_CallToolResultContent>& /* OutContent */);
+// Asynchronous form of FUMCP_ToolCall, returns straight away and resolves the completion later
+DECLARE_DELEGATE_TwoParams(FUMCP_ToolCallAsync, TSharedPtr<FJsonObject> /* arguments */, const TSharedRef<FUMCP_ToolCallCompletion>& /* Completion */);
 
 USTRUCT()
 struct UNREALMCPSERVER_API FUMCP_ToolDefinition
@@ -314,7 +410,10 @@ struct UNREALMCPSERVER_API FUMCP_ToolDefinition
 	FString description;
 
 	TSharedPtr<FJsonObject> inputSchema;
+	// Bind one of these. DoToolCallAsync wins if both are bound.
 	FUMCP_ToolCall DoToolCall;
+	FUMCP_ToolCallAsync DoToolCallAsync;
+	EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread;
 
 	FUMCP_ToolDefinition(): name{}, description{}, inputSchema{ MakeShared<FJsonObject>() }, DoToolCall()
 	{
@@ -379,7 +478,10 @@ struct FUMCP_ListResourcesParams
 	FString cursor;
 };
 
+using FUMCP_ResourceReadCompletion = TUMCP_AsyncCompletion<FUMCP_ReadResourceResultContent>;
+
 DECLARE_DELEGATE_RetVal_TwoParams(bool, FUMCP_ResourceRead, const FString& /* Uri */, TArray<FUMCP_ReadResourceResultContent>& /* OutContent */);
+DECLARE_DELEGATE_TwoParams(FUMCP_ResourceReadAsync, const FString& /* Uri */, const TSharedRef<FUMCP_ResourceReadCompletion>& /* Completion */);
 
 USTRUCT()
 struct UNREALMCPSERVER_API FUMCP_ResourceDefinition
@@ -402,7 +504,12 @@ struct UNREALMCPSERVER_API FUMCP_ResourceDefinition
 	UPROPERTY()
 	int32 size = 0;
 
+	// Bind one of these. ReadResourceAsync wins if both are bound.
 	FUMCP_ResourceRead ReadResource;
+	FUMCP_ResourceReadAsync ReadResourceAsync;
+	EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread;
+
+	bool IsBound() const { return ReadResource.IsBound() || ReadResourceAsync.IsBound(); }
 };
 
 USTRUCT()
@@ -427,6 +534,7 @@ struct FUMCP_ListResourceTemplatesParams
 };
 
 DECLARE_DELEGATE_RetVal_ThreeParams(bool, FUMCP_ResourceTemplateRead, const FUMCP_UriTemplate& /* Template */, const FUMCP_UriTemplateMatch& /* UriMatch */, TArray<FUMCP_ReadResourceResultContent>& /* OutContent */);
+DECLARE_DELEGATE_ThreeParams(FUMCP_ResourceTemplateReadAsync, const FUMCP_UriTemplate& /* Template */, const FUMCP_UriTemplateMatch& /* UriMatch */, const TSharedRef<FUMCP_ResourceReadCompletion>& /* Completion */);
 
 USTRUCT()
 struct FUMCP_ResourceTemplateDefinition
@@ -445,7 +553,12 @@ struct FUMCP_ResourceTemplateDefinition
 	UPROPERTY()
 	FString uriTemplate;
 
+	// Bind one of these. ReadResourceAsync wins if both are bound.
 	FUMCP_ResourceTemplateRead ReadResource;
+	FUMCP_ResourceTemplateReadAsync ReadResourceAsync;
+	EUMCP_ThreadAffinity ThreadAffinity = EUMCP_ThreadAffinity::GameThread;
+
+	bool IsBound() const { return ReadResource.IsBound() || ReadResourceAsync.IsBound(); }
 };
 
 USTRUCT()
@@ -9,6 +9,9 @@
 // Define a log category
 UNREALMCPSERVER_API DECLARE_LOG_CATEGORY_EXTERN(LogUnrealMCPServer, Log, All);
 
+// "stat UnrealMCPServer" shows the server's counters
+DECLARE_STATS_GROUP(TEXT("UnrealMCPServer"), STATGROUP_UnrealMCPServer, STATCAT_Advanced);
+
 class UNREALMCPSERVER_API FUnrealMCPServerModule : public IModuleInterface
 {
 public:
@@ -36,11 +36,13 @@ public class UnrealMCPServer : ModuleRules
 				"Slate",
 				"SlateCore",
 				"HTTPServer", // For HTTP server functionalities
+				"Sockets", // For FInternetAddr (request peer address)
 				"Json", // For FJsonObject
 				"JsonUtilities", // For FJsonObjectConverter
 				"HTTP",
 				"AssetRegistry", // For Blueprint search functionality
-				"BlueprintGraph" // For Blueprint graph analysis
+				"BlueprintGraph", // For Blueprint graph analysis
+				"Kismet" // For Find-in-Blueprints search data
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);